@@ -0,0 +1,125 @@
+#ifndef CAPTURE_TUNING_H
+#define CAPTURE_TUNING_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <cstring>
+
+// Host-level knobs for the capture path: which CPU a thread runs on and
+// which NUMA node the receive buffers live on. Uses the raw mbind system
+// call so there is no libnuma dependency.
+class CaptureTuning {
+public:
+    // Pins a thread to one CPU, or with cpu < 0 lets it run on any CPU the
+    // process may use. Returns false if the CPU does not exist or is not
+    // allowed for this process.
+    static bool pinThread(pthread_t thread, int cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (cpu < 0) {
+            if (sched_getaffinity(0, sizeof(set), &set) != 0) return false;
+        } else {
+            if (cpu >= CPU_SETSIZE) return false;
+            CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+    }
+
+    static bool pinCurrentThread(int cpu) {
+        return pinThread(pthread_self(), cpu);
+    }
+
+    static bool pinThread(pthread_t thread, const cpu_set_t& set) {
+        return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+    }
+
+    // CPUs the calling thread may run on, minus `excludeCpu` unless that
+    // would leave none. Helper threads use it to stay off the capture CPU.
+    static bool cpusExcept(int excludeCpu, cpu_set_t& set) {
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0) return false;
+        if (excludeCpu >= 0 && excludeCpu < CPU_SETSIZE && CPU_ISSET(excludeCpu, &set) && CPU_COUNT(&set) > 1) {
+            CPU_CLR(excludeCpu, &set);
+        }
+        return true;
+    }
+
+    static bool saveAffinity(cpu_set_t& set) {
+        return pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    static void restoreAffinity(const cpu_set_t& set) {
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    // NUMA node the interface's device is attached to, or -1 if unknown
+    // (virtual interfaces, single-node hosts).
+    static int nicNumaNode(const std::string& iface) {
+        std::ifstream in(("/sys/class/net/" + iface + "/device/numa_node").c_str());
+        int node = -1;
+        if (!(in >> node)) return -1;
+        return node;
+    }
+
+    static std::string nodeCpuList(int node) {
+        std::ostringstream path;
+        path << "/sys/devices/system/node/node" << node << "/cpulist";
+        std::ifstream in(path.str().c_str());
+        std::string cpus;
+        std::getline(in, cpus);
+        return cpus;
+    }
+};
+
+// Page-aligned buffer whose pages are placed on one NUMA node (node < 0:
+// wherever the kernel likes). Pages are touched up front so the capture
+// loop never takes a page fault on them.
+class NumaBuffer {
+private:
+    unsigned char* base;
+    size_t length;
+    bool nodeLocal;
+
+public:
+    NumaBuffer(size_t bytes, int node) : base(nullptr), length(bytes), nodeLocal(false) {
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::runtime_error("Cannot allocate capture buffer");
+        base = static_cast<unsigned char*>(p);
+
+        if (node >= 0 && node < static_cast<int>(sizeof(unsigned long) * 8)) {
+            const int kMpolPreferred = 1;
+            unsigned long mask = 1UL << node;
+            nodeLocal = syscall(SYS_mbind, base, length, kMpolPreferred, &mask, sizeof(mask) * 8 + 1, 0) == 0;
+        }
+        memset(base, 0, length);
+    }
+
+    ~NumaBuffer() {
+        munmap(base, length);
+    }
+
+    unsigned char* data() {
+        return base;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool isNodeLocal() const {
+        return nodeLocal;
+    }
+
+private:
+    NumaBuffer(const NumaBuffer&);
+    NumaBuffer& operator=(const NumaBuffer&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,95 @@
+#ifndef COLUMN_FILTER_H
+#define COLUMN_FILTER_H
+
+#include "PacketStore.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <cstdint>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Address filter evaluated over the packet store's metadata columns
+// instead of the packets themselves. Only the two 8-byte address-key
+// columns are read, two rows per SSE2 compare, with the store's chunks
+// split across a thread pool. The result is a selection vector: store
+// indexes of the candidate packets, in capture order. Only packets still
+// in memory are scanned.
+//
+// Keys of IPv6 addresses are hashes, so a candidate must still be
+// checked against the packet's address strings before it is used.
+class ColumnFilter {
+public:
+    struct AddressQuery {
+        uint64_t srcKey;
+        uint64_t dstKey;
+        bool anySrc;
+        bool anyDst;
+    };
+
+    enum { kChunksPerTask = 16 };
+
+    static std::vector<uint32_t> select(const PacketStore::Snapshot& snap, const AddressQuery& query,
+                                        ThreadPool& pool) {
+        size_t firstChunk = snap.firstChunk();
+        size_t chunks = snap.chunkCount();
+        size_t tasks = (chunks - firstChunk + kChunksPerTask - 1) / kChunksPerTask;
+        std::vector<std::vector<uint32_t> > parts(tasks);
+
+        pool.parallelFor(tasks, [&](size_t t) {
+            size_t last = std::min(chunks, firstChunk + (t + 1) * kChunksPerTask);
+            for (size_t ci = firstChunk + t * kChunksPerTask; ci < last; ci++) {
+                const PacketStore::Columns& cols = snap.columns(ci);
+                scanChunk(cols.srcKey, cols.dstKey, snap.rowsIn(ci), query,
+                          static_cast<uint32_t>(ci * PacketStore::kChunkSize), parts[t]);
+            }
+        });
+
+        size_t total = 0;
+        for (size_t t = 0; t < tasks; t++) total += parts[t].size();
+        std::vector<uint32_t> selection;
+        selection.reserve(total);
+        for (size_t t = 0; t < tasks; t++) selection.insert(selection.end(), parts[t].begin(), parts[t].end());
+        return selection;
+    }
+
+    static void scanChunk(const uint64_t* src, const uint64_t* dst, size_t rows, const AddressQuery& q,
+                          uint32_t base, std::vector<uint32_t>& out) {
+        size_t i = 0;
+#ifdef __SSE2__
+        const __m128i wantSrc = _mm_set1_epi64x(static_cast<long long>(q.srcKey));
+        const __m128i wantDst = _mm_set1_epi64x(static_cast<long long>(q.dstKey));
+        const __m128i all = _mm_set1_epi32(-1);
+        for (; i + 4 <= rows; i += 4) {
+            __m128i s0 = q.anySrc ? all : equal64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), wantSrc);
+            __m128i s1 = q.anySrc ? all : equal64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 2)), wantSrc);
+            __m128i d0 = q.anyDst ? all : equal64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i)), wantDst);
+            __m128i d1 = q.anyDst ? all : equal64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i + 2)), wantDst);
+            int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(s0, d0))) |
+                       (_mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(s1, d1))) << 2);
+            while (mask) {
+                int bit = __builtin_ctz(mask);
+                out.push_back(base + static_cast<uint32_t>(i + bit));
+                mask &= mask - 1;
+            }
+        }
+#endif
+        for (; i < rows; i++) {
+            if ((q.anySrc || src[i] == q.srcKey) && (q.anyDst || dst[i] == q.dstKey)) {
+                out.push_back(base + static_cast<uint32_t>(i));
+            }
+        }
+    }
+
+private:
+#ifdef __SSE2__
+    // 64-bit lane equality from 32-bit compares (pcmpeqq needs SSE4.1):
+    // a lane is equal when both of its halves are.
+    static __m128i equal64(__m128i a, __m128i b) {
+        __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+#endif
+};
+
+#endif
\ No newline at end of file
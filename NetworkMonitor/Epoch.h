@@ -0,0 +1,117 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <cstdint>
+
+// Epoch-based reclamation for structures that are published RCU-style:
+// readers pin the current epoch while they hold pointers into the
+// structure, the writer swaps in a new version and retires the old one,
+// and retired objects are freed only once every pinned reader has moved
+// past the epoch they were retired in. Readers never block the writer.
+class EpochManager {
+public:
+    enum { kMaxReaders = 64 };
+
+    // RAII pin held for the lifetime of a read-side snapshot.
+    class Guard {
+    public:
+        explicit Guard(EpochManager& manager) : mgr(manager), slot(manager.enter()) {}
+        ~Guard() { mgr.leave(slot); }
+
+    private:
+        EpochManager& mgr;
+        int slot;
+
+        Guard(const Guard&);
+        Guard& operator=(const Guard&);
+    };
+
+private:
+    struct Retired {
+        uint64_t epoch;
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    std::atomic<uint64_t> globalEpoch;
+    std::atomic<uint64_t> readers[kMaxReaders];    // 0 = slot free
+    std::vector<Retired> retired;                  // writer side only
+
+public:
+    EpochManager() : globalEpoch(1) {
+        for (int i = 0; i < kMaxReaders; i++) readers[i].store(0);
+    }
+
+    ~EpochManager() {
+        for (size_t i = 0; i < retired.size(); i++) retired[i].deleter(retired[i].ptr);
+    }
+
+    // Hands an unlinked object to the reclaimer. Must be called by the
+    // single writer after the new version has been published.
+    template <typename T>
+    void retire(T* ptr) {
+        Retired r;
+        r.epoch = globalEpoch.fetch_add(1);
+        r.ptr = ptr;
+        r.deleter = &deleteAs<T>;
+        retired.push_back(r);
+        reclaim();
+    }
+
+    bool hasPending() const {
+        return !retired.empty();
+    }
+
+    // Frees every retired object no reader can still be looking at.
+    void reclaim() {
+        if (retired.empty()) return;
+
+        uint64_t oldest = UINT64_MAX;
+        for (int i = 0; i < kMaxReaders; i++) {
+            uint64_t e = readers[i].load();
+            if (e != 0 && e < oldest) oldest = e;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < retired.size(); i++) {
+            if (retired[i].epoch < oldest) {
+                retired[i].deleter(retired[i].ptr);
+            } else {
+                retired[kept++] = retired[i];
+            }
+        }
+        retired.resize(kept);
+    }
+
+private:
+    int enter() {
+        for (;;) {
+            uint64_t e = globalEpoch.load();
+            for (int i = 0; i < kMaxReaders; i++) {
+                uint64_t expected = 0;
+                if (readers[i].load(std::memory_order_relaxed) == 0 &&
+                    readers[i].compare_exchange_strong(expected, e)) {
+                    return i;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void leave(int slot) {
+        readers[slot].store(0, std::memory_order_release);
+    }
+
+    template <typename T>
+    static void deleteAs(void* p) {
+        delete static_cast<T*>(p);
+    }
+
+    EpochManager(const EpochManager&);
+    EpochManager& operator=(const EpochManager&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,229 @@
+#ifndef FRAME_DEDUPLICATOR_H
+#define FRAME_DEDUPLICATOR_H
+
+#include <net/ethernet.h>
+#include <netinet/in.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Drops repeated copies of the same frame, as seen on SPAN ports and
+// aggregated taps. Each frame is hashed from the IP header onwards with
+// the fields that change hop by hop (MACs, IPv4 TTL and header checksum,
+// IPv6 hop limit, TCP/UDP checksum) zeroed, and the hash is looked up in
+// an open-addressing table whose entries expire after a short window.
+class FrameDeduplicator {
+private:
+    struct Entry {
+        uint64_t hash;          // 0 = empty
+        int64_t seenUsec;
+    };
+
+    std::vector<Entry> table;
+    size_t used;
+    int64_t windowUsec;
+    uint64_t checked;
+    uint64_t duplicates;
+
+public:
+    explicit FrameDeduplicator(int windowMs = 20, size_t initialSlots = 1 << 14)
+        : table(roundUp(initialSlots)), used(0),
+          windowUsec(static_cast<int64_t>(windowMs) * 1000), checked(0), duplicates(0) {
+        clear();
+    }
+
+    void setWindow(int windowMs) {
+        windowUsec = static_cast<int64_t>(windowMs) * 1000;
+    }
+
+    int getWindowMs() const {
+        return static_cast<int>(windowUsec / 1000);
+    }
+
+    uint64_t framesChecked() const {
+        return checked;
+    }
+
+    uint64_t duplicatesDropped() const {
+        return duplicates;
+    }
+
+    void clear() {
+        Entry empty = { 0, 0 };
+        std::fill(table.begin(), table.end(), empty);
+        used = 0;
+        checked = 0;
+        duplicates = 0;
+    }
+
+    // Returns true if an identical frame was seen within the window.
+    // Otherwise remembers this one and returns false.
+    bool isDuplicate(const unsigned char* frame, size_t len, int64_t nowUsec) {
+        checked++;
+        uint64_t h = hashFrame(frame, len);
+        size_t mask = table.size() - 1;
+        size_t reuse = table.size();
+
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            Entry& e = table[i];
+            if (e.hash == 0) {
+                if (reuse == table.size()) {
+                    reuse = i;
+                    used++;
+                }
+                break;
+            }
+            bool live = nowUsec - e.seenUsec <= windowUsec;
+            if (e.hash == h) {
+                if (live) {
+                    duplicates++;
+                    return true;
+                }
+                e.seenUsec = nowUsec;
+                return false;
+            }
+            if (!live && reuse == table.size()) reuse = i;
+        }
+
+        table[reuse].hash = h;
+        table[reuse].seenUsec = nowUsec;
+        if (used * 10 > table.size() * 7) rehash(nowUsec);
+        return false;
+    }
+
+    static uint64_t hashFrame(const unsigned char* frame, size_t len) {
+        size_t l3 = sizeof(struct ether_header);
+        if (len <= l3) return finish(hashBytes(frame, len, 0));
+
+        uint16_t etherType = static_cast<uint16_t>((frame[12] << 8) | frame[13]);
+        size_t l4 = l3;
+        int proto = -1;
+        if (etherType == ETHERTYPE_IP && len >= l3 + 20) {
+            l4 = l3 + (frame[l3] & 0x0f) * 4;
+            proto = frame[l3 + 9];
+        } else if (etherType == ETHERTYPE_IPV6 && len >= l3 + 40) {
+            l4 = l3 + 40;
+            proto = frame[l3 + 6];
+        }
+
+        size_t headerEnd = l4;
+        if (proto == IPPROTO_TCP && len >= l4 + 20) {
+            headerEnd = l4 + (frame[l4 + 12] >> 4) * 4;
+        } else if (proto == IPPROTO_UDP && len >= l4 + 8) {
+            headerEnd = l4 + 8;
+        }
+        if (headerEnd > len || headerEnd - l3 > 128) headerEnd = l4 <= len ? l4 : len;
+
+        // Copy the headers so the mutable fields can be blanked.
+        unsigned char hdr[128];
+        size_t hdrLen = headerEnd - l3;
+        if (hdrLen > sizeof(hdr)) hdrLen = sizeof(hdr);
+        memcpy(hdr, frame + l3, hdrLen);
+        if (etherType == ETHERTYPE_IP && hdrLen >= 20) {
+            hdr[8] = 0;                                 // TTL
+            hdr[10] = hdr[11] = 0;                      // header checksum
+        } else if (etherType == ETHERTYPE_IPV6 && hdrLen >= 40) {
+            hdr[7] = 0;                                 // hop limit
+        }
+        size_t l4Rel = l4 - l3;
+        if (proto == IPPROTO_TCP && hdrLen >= l4Rel + 18) {
+            hdr[l4Rel + 16] = hdr[l4Rel + 17] = 0;
+        } else if (proto == IPPROTO_UDP && hdrLen >= l4Rel + 8) {
+            hdr[l4Rel + 6] = hdr[l4Rel + 7] = 0;
+        }
+
+        uint64_t h = hashBytes(hdr, hdrLen, 0);
+        h = hashBytes(frame + l3 + hdrLen, len - l3 - hdrLen, h);
+        return finish(h);
+    }
+
+private:
+    static size_t roundUp(size_t n) {
+        size_t p = 1024;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static uint64_t rotl(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static uint64_t read64(const unsigned char* p) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    // Four independent 64-bit lanes consume 32 bytes per step, so the
+    // multiplies pipeline instead of forming one long dependency chain.
+    static uint64_t hashBytes(const unsigned char* p, size_t len, uint64_t seed) {
+        const uint64_t k1 = 0x9E3779B185EBCA87ULL;
+        const uint64_t k2 = 0xC2B2AE3D27D4EB4FULL;
+        uint64_t h;
+
+        if (len >= 32) {
+            uint64_t v1 = seed + k1 + k2, v2 = seed + k2, v3 = seed, v4 = seed - k1;
+            const unsigned char* end = p + len - 32;
+            do {
+                v1 = rotl(v1 + read64(p) * k2, 31) * k1;
+                v2 = rotl(v2 + read64(p + 8) * k2, 31) * k1;
+                v3 = rotl(v3 + read64(p + 16) * k2, 31) * k1;
+                v4 = rotl(v4 + read64(p + 24) * k2, 31) * k1;
+                p += 32;
+            } while (p <= end);
+            h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+            len &= 31;
+        } else {
+            h = seed + 0x165667B19E3779F9ULL;
+        }
+
+        h += len;
+        for (; len >= 8; len -= 8, p += 8) {
+            h ^= rotl(read64(p) * k2, 31) * k1;
+            h = rotl(h, 27) * k1 + 0x85EBCA77C2B2AE63ULL;
+        }
+        for (; len > 0; len--, p++) {
+            h ^= *p * 0x27D4EB2F165667C5ULL;
+            h = rotl(h, 11) * k1;
+        }
+        return h;
+    }
+
+    static uint64_t finish(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xC2B2AE3D27D4EB4FULL;
+        h ^= h >> 29;
+        h *= 0x165667B19E3779F9ULL;
+        h ^= h >> 32;
+        return h ? h : 1;
+    }
+
+    // Rebuilds the table keeping only live entries, doubling it if the
+    // live set alone would keep it over half full.
+    void rehash(int64_t nowUsec) {
+        std::vector<Entry> old;
+        old.swap(table);
+
+        size_t live = 0;
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i].hash != 0 && nowUsec - old[i].seenUsec <= windowUsec) live++;
+        }
+        size_t slots = old.size();
+        while (live * 2 > slots) slots <<= 1;
+
+        Entry empty = { 0, 0 };
+        table.assign(slots, empty);
+        used = 0;
+        size_t mask = slots - 1;
+        for (size_t i = 0; i < old.size(); i++) {
+            if (old[i].hash == 0 || nowUsec - old[i].seenUsec > windowUsec) continue;
+            size_t j = old[i].hash & mask;
+            while (table[j].hash != 0) j = (j + 1) & mask;
+            table[j] = old[i];
+            used++;
+        }
+    }
+};
+
+#endif
\ No newline at end of file
@@ -4,7 +4,23 @@
 #include "Packet.h"
 #include "Queue.h"
 #include "PacketAnalyzer.h"
+#include "PacketStore.h"
+#include "SegmentStore.h"
+#include "TcpReassembler.h"
+#include "StreamDumper.h"
+#include "FrameDeduplicator.h"
+#include "PayloadCompressor.h"
+#include "TrafficGenerator.h"
+#include "SpscRing.h"
+#include "OverloadController.h"
+#include "SignatureScanner.h"
+#include "CaptureTuning.h"
+#include "ColumnFilter.h"
+#include "StandingFilter.h"
 #include <sys/socket.h>
+#include <sys/epoll.h>
+#include <poll.h>
+#include <fcntl.h>
 #include <linux/if_packet.h>
 #include <net/ethernet.h>
 #include <net/if.h>
@@ -13,169 +29,777 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <climits>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <sstream>
+#include <fstream>
+#include <functional>
+#include <mutex>
 
 class NetworkMonitor {
 private:
-    int sock;
+    // One non-blocking raw socket per captured interface, all serviced by
+    // a single epoll loop on the capture thread.
+    struct CaptureSocket {
+        std::string name;
+        int fd;
+        int ifIndex;
+    };
+    
+    // A frame read from any socket during one epoll wakeup; the batch is
+    // put in timestamp order before it is stored.
+    struct PendingFrame {
+        size_t offset;
+        size_t length;
+        timeval timestamp;
+        int ifIndex;
+    };
+    
+    std::vector<CaptureSocket> sockets;
+    std::unique_ptr<std::atomic<uint64_t>[]> ingressCounts;
+    int epollFd;
     std::string interface;
     
-    Queue<Packet> packetQueue;           
+    PacketStore packetQueue;             
     Queue<Packet> filteredQueue;         
     Queue<Packet> backupQueue;           
     
+    SegmentStore diskStore;              
+    size_t memoryLimit;                  // packets kept in RAM once on disk, 0 = all
+    int lastDiskId;                      // newest packet written to diskStore
+    std::string lastDiskDir;
+    
     PacketAnalyzer analyzer;
+    TcpReassembler reassembler;
+    bool reassemblyEnabled;
+    StreamDumper streamDumper;
+    FrameDeduplicator deduplicator;
+    bool dedupEnabled;
+    std::atomic<uint64_t> duplicateFrames;
+    
+    std::atomic<bool> compressionEnabled;
+    std::thread compressThread;
+    std::atomic<uint64_t> compressedChunks;
+    std::atomic<uint64_t> bytesBeforeCompression;
+    std::atomic<uint64_t> bytesAfterCompression;
+    PayloadCompressor::Inflater inflater;
     std::atomic<bool> capturing;
+    std::thread captureThread;
     int oversizedThreshold;
     int oversizedCount;
+    int nextPacketId;
+    TrafficGenerator::Config trafficConfig;
+    OverloadController overload;
+    std::atomic<uint64_t> weightedPackets;      // packets stored, scaled by sampling
+    int64_t lastStoredUsec;                     // newest timestamp stored so far
+    
+    std::shared_ptr<const SignatureScanner> scanner;
+    std::unique_ptr<std::atomic<uint64_t>[]> signatureCounts;
+    std::atomic<uint64_t> scannedPackets;
+    std::atomic<uint64_t> scannedBytes;
+    std::atomic<uint64_t> flaggedPackets;
+    
+    // Low-latency capture settings (see setCaptureTuning).
+    int captureCpu;                 // -1 = let the scheduler decide
+    int workerCpu;
+    bool busyPoll;
+    bool numaBuffers;
+    
+    // One line per finished capture so modes can be compared on a host.
+    struct CaptureRun {
+        std::string mode;
+        int seconds;
+        uint64_t packets;
+        uint64_t kernelDrops;
+        uint64_t shed;
+    };
+    std::vector<CaptureRun> captureRuns;
+    std::mutex captureRunsLock;
+    
+    // Created on the first filter scan (see filterThreads).
+    std::unique_ptr<ThreadPool> filterPool;
+    
+    // Filters evaluated during capture; only changed while none is running.
+    std::vector<std::unique_ptr<StandingFilter> > standingFilters;
+    
+    // Copy of the reassembler counters published by the capture thread so
+    // statistics can be read while a background capture is running.
+    struct StreamSummary {
+        std::atomic<uint64_t> activeFlows;
+        std::atomic<uint64_t> bufferedBytes;
+        std::atomic<uint64_t> flowsOpened;
+        std::atomic<uint64_t> flowsClosed;
+        std::atomic<uint64_t> flowsEvicted;
+        std::atomic<uint64_t> bytesDelivered;
+        std::atomic<uint64_t> gapBytes;
+        
+        StreamSummary() : activeFlows(0), bufferedBytes(0), flowsOpened(0), flowsClosed(0),
+                          flowsEvicted(0), bytesDelivered(0), gapBytes(0) {}
+    } streamSummary;
     
 public:
     NetworkMonitor(const std::string& iface) 
-        : interface(iface), capturing(false), oversizedThreshold(5), oversizedCount(0) {
+        : interface(iface), memoryLimit(0), lastDiskId(0), reassemblyEnabled(false), dedupEnabled(false), duplicateFrames(0),
+          compressionEnabled(false), compressedChunks(0), bytesBeforeCompression(0),
+          bytesAfterCompression(0), capturing(false),
+          oversizedThreshold(5), oversizedCount(0), nextPacketId(1), weightedPackets(0), lastStoredUsec(0),
+          scannedPackets(0), scannedBytes(0), flaggedPackets(0),
+          captureCpu(-1), workerCpu(-1), busyPoll(false), numaBuffers(false) {
         
-        sock = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
-        if (sock < 0) {
-            perror("Socket creation failed. Run with sudo/root privileges");
-            exit(1);
+        epollFd = -1;
+        
+        // "synthetic" needs no privileges: captures come from a
+        // TrafficGenerator and replay goes nowhere.
+        if (interface == "synthetic") {
+            std::cout << "✅ Network Monitor initialized with a synthetic traffic source\n";
+            std::cout << "✅ No raw socket needed (replayed packets are discarded)\n";
+            return;
         }
         
-        struct ifreq ifr;
-        memset(&ifr, 0, sizeof(ifr));
-        strncpy(ifr.ifr_name, interface.c_str(), IFNAMSIZ - 1);
+        epollFd = epoll_create1(0);
+        if (epollFd < 0) {
+            perror("epoll_create1 failed");
+            exit(1);
+        }
         
-        if (setsockopt(sock, SOL_SOCKET, SO_BINDTODEVICE, &ifr, sizeof(ifr)) < 0) {
-            perror("Binding to interface failed");
-            close(sock);
+        // "eth0,eth1" captures both sides of a router into one store.
+        std::stringstream names(interface);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            if (!name.empty()) openInterface(name);
+        }
+        if (sockets.empty()) {
+            std::cerr << "No interface given\n";
             exit(1);
         }
+        ingressCounts.reset(new std::atomic<uint64_t>[sockets.size()]);
+        for (size_t i = 0; i < sockets.size(); i++) ingressCounts[i].store(0);
         
         std::cout << "✅ Network Monitor initialized on interface: " << interface << std::endl;
-        std::cout << "✅ Raw socket created successfully\n";
+        std::cout << "✅ Raw socket" << (sockets.size() > 1 ? "s" : "") << " created successfully\n";
     }
     
     ~NetworkMonitor() { 
         capturing = false;
-        close(sock); 
+        if (captureThread.joinable()) captureThread.join();
+        compressionEnabled = false;
+        if (compressThread.joinable()) compressThread.join();
+        for (size_t i = 0; i < sockets.size(); i++) close(sockets[i].fd);
+        if (epollFd >= 0) close(epollFd);
     }
 
     void capturePacketsContinuous(int duration = 60) {
-        unsigned char buffer[65536];
-        int id = 1;
-        capturing = true;
+        if (capturing) {
+            std::cout << "\n⚠️  A background capture is already running.\n";
+            return;
+        }
+        if (captureThread.joinable()) captureThread.join();
         
         std::cout << "\n🔍 CONTINUOUS PACKET CAPTURE for " << duration << " seconds\n";
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
         
+        capturing = true;
+        int captured = captureLoop(duration, true);
+        
+        std::cout << "\n✅ Continuous capture complete. Total: " << captured << " packets\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    }
+
+    // Runs the capture loop on its own thread so display, filter and
+    // statistics commands keep working; they read consistent snapshots of
+    // the stores while packets are being appended.
+    void startCapture(int duration) {
+        if (capturing) {
+            std::cout << "\n⚠️  A background capture is already running.\n";
+            return;
+        }
+        if (captureThread.joinable()) captureThread.join();
+        
+        capturing = true;
+        captureThread = std::thread([this, duration]() {
+            int captured = captureLoop(duration, false);
+            std::cout << "\n✅ Background capture finished. Total: " << captured << " packets\n";
+        });
+        std::cout << "\n🔍 Background capture started for " << duration << " seconds\n";
+    }
+
+    void stopCapture() {
+        if (!capturing && !captureThread.joinable()) {
+            std::cout << "\n⚠️  No background capture is running.\n";
+            return;
+        }
+        capturing = false;
+        if (captureThread.joinable()) captureThread.join();
+    }
+
+    bool isCapturing() const {
+        return capturing;
+    }
+
+    bool isSynthetic() const {
+        return sockets.empty();
+    }
+
+    // Packets per second a synthetic capture generates.
+    void setSyntheticRate(int pps) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (pps <= 0) {
+            std::cout << "❌ Invalid rate\n";
+            return;
+        }
+        trafficConfig.pps = pps;
+    }
+
+private:
+    int captureLoop(int duration, bool verbose) {
+        int captured = 0;
+        analyzer.setVerbose(verbose);
+        
+        // The foreground capture runs on the menu thread, so its affinity
+        // is put back afterwards.
+        cpu_set_t savedAffinity;
+        bool pinned = captureCpu >= 0 && CaptureTuning::saveAffinity(savedAffinity) &&
+                      CaptureTuning::pinCurrentThread(captureCpu);
+        if (captureCpu >= 0 && !pinned) {
+            std::cout << "⚠️  Could not pin capture to CPU " << captureCpu << "\n";
+        }
+        
+        uint64_t kernelDrops = 0;
+        uint64_t shedBefore = overload.packetsShed();
+        readKernelDrops();          // discard drops from before this capture
+        
         auto startTime = std::chrono::steady_clock::now();
         auto endTime = startTime + std::chrono::seconds(duration);
+        auto nextExpiry = startTime + std::chrono::seconds(1);
         
-        struct timeval tv;
-        tv.tv_sec = 1;
-        tv.tv_usec = 0;
-        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        std::unique_ptr<TrafficGenerator> generator;
+        uint64_t generated = 0;
+        if (sockets.empty()) generator.reset(new TrafficGenerator(trafficConfig));
+        
+        std::unique_ptr<NumaBuffer> arena;
+        if (!sockets.empty()) {
+            int node = numaBuffers ? CaptureTuning::nicNumaNode(sockets[0].name) : -1;
+            arena.reset(new NumaBuffer(sockets.size() * kBatchPerSocket * kMaxFrame, node));
+        }
+        std::vector<PendingFrame> batch;
+        auto nextDropCheck = startTime;
         
         while (capturing && std::chrono::steady_clock::now() < endTime) {
-            ssize_t size = recvfrom(sock, buffer, sizeof(buffer), 0, nullptr, nullptr);
+            int stored = 0;
             
-            if (size > 0) {
-                Packet p(id++, buffer, size);
-   
-                analyzer.dissect(p);
+            if (generator) {
+                // Paced to the configured rate, like frames arriving on a link.
+                double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+                double due = elapsed * generator->getConfig().pps;
+                if ((generated & 255) == 0) {
+                    // Frames behind schedule, against the same 4096-frame
+                    // budget the load test's receive ring has.
+                    overload.observe(0, std::min(1.0, (due - generated) / 4096.0), steadyUsec());
+                }
+                if (generated >= due) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                } else {
+                    size_t len;
+                    const unsigned char* frame = generator->next(len);
+                    generated++;
+                    stored = ingestFrame(frame, len) ? 1 : 0;
+                }
+            } else {
+                readBatch(*arena, batch);
                 
-                packetQueue.enqueue(p);
+                uint64_t drops = 0;
+                if (std::chrono::steady_clock::now() >= nextDropCheck) {
+                    drops = readKernelDrops();
+                    kernelDrops += drops;
+                    nextDropCheck += std::chrono::milliseconds(250);
+                }
+                overload.observe(drops, static_cast<double>(batch.size()) / (sockets.size() * kBatchPerSocket),
+                                 steadyUsec());
                 
-                if (id % 10 == 0) {
-                    std::cout << "📦 Captured and dissected " << id - 1 << " packets...\r" << std::flush;
+                // Merge the interfaces by kernel receive time. Within a batch
+                // the sort does it; across batches ingestFrame clamps a frame
+                // that is still older than one already stored.
+                std::stable_sort(batch.begin(), batch.end(),
+                                 [](const PendingFrame& a, const PendingFrame& b) {
+                                     return PacketStore::toUsec(a.timestamp) < PacketStore::toUsec(b.timestamp);
+                                 });
+                for (size_t i = 0; i < batch.size(); i++) {
+                    PendingFrame& f = batch[i];
+                    if (ingestFrame(arena->data() + f.offset, f.length, &f.timestamp, f.ifIndex)) stored++;
+                }
+            }
+            
+            for (int i = 0; i < stored; i++) {
+                captured++;
+                if (verbose && captured % 10 == 0) {
+                    std::cout << "📦 Captured and dissected " << captured << " packets...\r" << std::flush;
                 }
             }
+            
+            if (reassemblyEnabled && std::chrono::steady_clock::now() >= nextExpiry) {
+                expireStreams();
+                nextExpiry += std::chrono::seconds(1);
+            }
+        }
+        
+        if (reassemblyEnabled) {
+            publishStreamSummary();
+            streamDumper.flush();
+        }
+        analyzer.setVerbose(true);
+        if (pinned) CaptureTuning::restoreAffinity(savedAffinity);
+        
+        CaptureRun run;
+        run.mode = describeCaptureMode(arena && arena->isNodeLocal());
+        run.seconds = static_cast<int>(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - startTime).count());
+        run.packets = captured;
+        run.kernelDrops = kernelDrops + readKernelDrops();
+        run.shed = overload.packetsShed() - shedBefore;
+        {
+            std::lock_guard<std::mutex> lock(captureRunsLock);
+            captureRuns.push_back(run);
         }
         
         capturing = false;
-        std::cout << "\n✅ Continuous capture complete. Total: " << (id - 1) << " packets\n";
-        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        return captured;
+    }
+
+    std::string describeCaptureMode(bool nodeLocal) const {
+        std::ostringstream mode;
+        if (captureCpu >= 0) mode << "cpu " << captureCpu; else mode << "unpinned";
+        mode << (busyPoll ? ", busy-poll" : ", interrupt");
+        if (nodeLocal) mode << ", numa buffers";
+        return mode.str();
+    }
+
+    // Per-frame pipeline shared by live capture, synthetic capture and the
+    // load test: duplicate check, dissect, store, standing filters,
+    // reassemble. Returns false if the frame was dropped as a duplicate.
+    bool ingestFrame(const unsigned char* frame, size_t size, const timeval* timestamp = nullptr, int ifIndex = 0) {
+        if (!overload.admit(frame, size)) return false;
+        
+        if (dedupEnabled) {
+            struct timeval now;
+            if (timestamp) now = *timestamp; else gettimeofday(&now, nullptr);
+            if (deduplicator.isDuplicate(frame, size, PacketStore::toUsec(now))) {
+                duplicateFrames.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        
+        Packet p(nextPacketId++, frame, size);
+        if (timestamp) p.timestamp = *timestamp;
+        // The stores' time searches need timestamps that never decrease. A
+        // frame older than the newest one stored (wall clock stepped back,
+        // a late frame from another interface) takes the newest time.
+        if (PacketStore::toUsec(p.timestamp) < lastStoredUsec) {
+            p.timestamp.tv_sec = static_cast<time_t>(lastStoredUsec / 1000000);
+            p.timestamp.tv_usec = static_cast<suseconds_t>(lastStoredUsec % 1000000);
+        }
+        lastStoredUsec = PacketStore::toUsec(p.timestamp);
+        p.ifIndex = ifIndex;
+        p.sampleWeight = overload.sampleWeight();
+        analyzer.dissect(p);
+        if (scanner && scannedLength(p) > 0) scanPayload(p);
+        
+        uint64_t generation;
+        size_t index = packetQueue.append(p, &generation);
+        if (diskStore.isOpen()) {
+            storeOnDisk(p);
+            // Whole chunks leave memory once the store holds them.
+            if (memoryLimit > 0 && packetQueue.size() % PacketStore::kChunkSize == 0 && diskStore.isOpen()) {
+                packetQueue.evictOldest(memoryLimit);
+            }
+        }
+        for (size_t i = 0; i < standingFilters.size(); i++) standingFilters[i]->offer(p, index, generation);
+        if (reassemblyEnabled) reassembler.process(p);
+        weightedPackets.fetch_add(p.sampleWeight, std::memory_order_relaxed);
+        return true;
+    }
+
+    // A store that cannot start its next segment (disk full, directory
+    // gone) is closed; capture carries on in memory.
+    void storeOnDisk(const Packet& p) {
+        try {
+            diskStore.append(p);
+            lastDiskId = p.id;
+        } catch (const std::exception& e) {
+            std::cout << "\n❌ Persistent store: " << e.what() << "\n";
+            std::cout << "⚠️  Persistent store closed; packets from " << p.id << " on are kept in memory only\n";
+            diskStore.close();
+        }
+    }
+
+    // Bytes of a packet the signature scan covers: the TCP/UDP payload,
+    // without Ethernet padding (or bytes cut off by the snap length).
+    static size_t scannedLength(const Packet& p) {
+        if (p.ipProtocol != IPPROTO_TCP && p.ipProtocol != IPPROTO_UDP) return 0;
+        if (p.payloadOffset >= p.data.size()) return 0;
+        return std::min(p.payloadLength, p.data.size() - p.payloadOffset);
+    }
+
+    void scanPayload(Packet& p) {
+        size_t len = scannedLength(p);
+        size_t hits = scanner->scan(p.data.data() + p.payloadOffset, len,
+            [&](uint32_t id, size_t) {
+                if (p.firstSignature < 0) p.firstSignature = static_cast<int32_t>(id);
+                signatureCounts[id].fetch_add(1, std::memory_order_relaxed);
+            });
+        
+        scannedPackets.fetch_add(1, std::memory_order_relaxed);
+        scannedBytes.fetch_add(len, std::memory_order_relaxed);
+        if (hits > 0) {
+            p.signatureHits = static_cast<uint16_t>(std::min<size_t>(hits, 65535));
+            flaggedPackets.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void expireStreams() {
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        reassembler.expire(PacketStore::toUsec(now));
+        publishStreamSummary();
+    }
+
+    enum { kBatchPerSocket = 64, kMaxFrame = 65536 };
+    
+    // Waits up to 100 ms for any socket to become readable, then drains
+    // each ready socket (at most kBatchPerSocket frames, so one busy link
+    // cannot starve the others) into `arena`. In busy-poll mode the wait
+    // does not sleep: the loop spins on epoll_wait(0) and the sockets'
+    // SO_BUSY_POLL lets the kernel poll the NIC queue directly instead of
+    // waiting for an interrupt.
+    void readBatch(NumaBuffer& arena, std::vector<PendingFrame>& batch) {
+        enum { kMaxEvents = 16 };
+        size_t used = 0;
+        batch.clear();
+        
+        struct epoll_event events[kMaxEvents];
+        int ready = epoll_wait(epollFd, events, kMaxEvents, busyPoll ? 0 : 100);
+        for (int e = 0; e < ready; e++) {
+            size_t si = events[e].data.u32;
+            const CaptureSocket& cs = sockets[si];
+            
+            for (int n = 0; n < kBatchPerSocket; n++) {
+                size_t offset = used;
+                
+                struct iovec iov;
+                iov.iov_base = arena.data() + offset;
+                iov.iov_len = kMaxFrame;
+                char control[CMSG_SPACE(sizeof(struct timeval))];
+                struct msghdr msg;
+                memset(&msg, 0, sizeof(msg));
+                msg.msg_iov = &iov;
+                msg.msg_iovlen = 1;
+                msg.msg_control = control;
+                msg.msg_controllen = sizeof(control);
+                
+                ssize_t size = recvmsg(cs.fd, &msg, 0);
+                if (size <= 0) break;
+                used += (static_cast<size_t>(size) + 63) & ~static_cast<size_t>(63);
+                
+                PendingFrame f;
+                f.offset = offset;
+                f.length = static_cast<size_t>(size);
+                f.ifIndex = cs.ifIndex;
+                bool stamped = false;
+                for (struct cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+                    if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMP) {
+                        memcpy(&f.timestamp, CMSG_DATA(c), sizeof(f.timestamp));
+                        stamped = true;
+                    }
+                }
+                if (!stamped) gettimeofday(&f.timestamp, nullptr);
+                batch.push_back(f);
+                ingressCounts[si].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Frames the kernel dropped on all sockets since the last call
+    // (PACKET_STATISTICS resets its counters when read).
+    uint64_t readKernelDrops() {
+        uint64_t drops = 0;
+        for (size_t i = 0; i < sockets.size(); i++) {
+            struct tpacket_stats st;
+            socklen_t len = sizeof(st);
+            if (getsockopt(sockets[i].fd, SOL_PACKET, PACKET_STATISTICS, &st, &len) == 0) drops += st.tp_drops;
+        }
+        return drops;
+    }
+
+    static int64_t steadyUsec() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void openInterface(const std::string& name) {
+        CaptureSocket cs;
+        cs.name = name;
+        cs.ifIndex = static_cast<int>(if_nametoindex(name.c_str()));
+        if (cs.ifIndex == 0) {
+            perror(("Unknown interface " + name).c_str());
+            exit(1);
+        }
+        
+        cs.fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+        if (cs.fd < 0) {
+            perror("Socket creation failed. Run with sudo/root privileges");
+            exit(1);
+        }
+        
+        // bind() rather than SO_BINDTODEVICE: packet sockets only honour
+        // the interface given at bind time, and each socket must see its
+        // own link only for the ingress tag to be right.
+        struct sockaddr_ll sll;
+        memset(&sll, 0, sizeof(sll));
+        sll.sll_family = AF_PACKET;
+        sll.sll_protocol = htons(ETH_P_ALL);
+        sll.sll_ifindex = cs.ifIndex;
+        if (bind(cs.fd, reinterpret_cast<struct sockaddr*>(&sll), sizeof(sll)) < 0) {
+            perror("Binding to interface failed");
+            close(cs.fd);
+            exit(1);
+        }
+        
+        int on = 1;
+        setsockopt(cs.fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on));
+        fcntl(cs.fd, F_SETFL, fcntl(cs.fd, F_GETFL) | O_NONBLOCK);
+        
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.u32 = static_cast<uint32_t>(sockets.size());
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, cs.fd, &ev) < 0) {
+            perror("epoll_ctl failed");
+            close(cs.fd);
+            exit(1);
+        }
+        sockets.push_back(cs);
+    }
+
+    // Replays a packet on the interface it arrived on (the first interface
+    // if that one is not captured). Without sockets (synthetic mode) every
+    // frame is accepted and discarded, so the replay path can still be
+    // exercised.
+    ssize_t transmit(const Packet& p) {
+        if (sockets.empty()) return static_cast<ssize_t>(p.size);
+        
+        int fd = sockets[0].fd;
+        for (size_t i = 0; i < sockets.size(); i++) {
+            if (sockets[i].ifIndex == p.ifIndex) fd = sockets[i].fd;
+        }
+        
+        ssize_t sent = send(fd, p.data.data(), p.size, 0);
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            struct pollfd pfd = { fd, POLLOUT, 0 };
+            if (poll(&pfd, 1, 100) > 0) sent = send(fd, p.data.data(), p.size, 0);
+        }
+        return sent;
+    }
+
+    // Background worker: replaces every full, not yet compacted chunk of
+    // the packet store with a copy whose payloads live in compressed
+    // blocks. Runs off the capture thread; the capture path only ever
+    // waits for the pointer swap inside replaceChunk().
+    void compressionLoop() {
+        if (workerCpu >= 0) CaptureTuning::pinCurrentThread(workerCpu);
+        size_t nextChunk = 0;
+        uint64_t generation = 0;
+        
+        while (compressionEnabled) {
+            bool worked = false;
+            {
+                PacketStore::Snapshot snap(packetQueue);
+                if (snap.generation() != generation) {
+                    generation = snap.generation();
+                    nextChunk = 0;
+                }
+                nextChunk = std::max(nextChunk, snap.firstChunk());
+                
+                for (; nextChunk < snap.fullChunks() && compressionEnabled; nextChunk++) {
+                    if (snap.isChunkCompacted(nextChunk)) continue;
+                    
+                    std::vector<Packet> packets;
+                    packets.reserve(PacketStore::kChunkSize);
+                    size_t before = 0;
+                    for (size_t i = 0; i < PacketStore::kChunkSize; i++) {
+                        packets.push_back(snap.at(nextChunk * PacketStore::kChunkSize + i));
+                        before += packets.back().data.size();
+                    }
+                    
+                    size_t after = 0;
+                    for (size_t b = 0; b < packets.size(); b += PayloadCompressor::kPacketsPerBlock) {
+                        after += PayloadCompressor::compressRange(packets, b, b + PayloadCompressor::kPacketsPerBlock);
+                    }
+                    for (size_t i = 0; i < packets.size(); i++) after += packets[i].data.size();
+                    
+                    if (packetQueue.replaceChunk(nextChunk, generation, packets)) {
+                        compressedChunks.fetch_add(1, std::memory_order_relaxed);
+                        bytesBeforeCompression.fetch_add(before, std::memory_order_relaxed);
+                        bytesAfterCompression.fetch_add(after, std::memory_order_relaxed);
+                    }
+                    worked = true;
+                }
+            }
+            if (!worked) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }
+
+    void publishStreamSummary() {
+        const TcpReassembler::Stats& rs = reassembler.getStats();
+        streamSummary.activeFlows.store(reassembler.activeFlows(), std::memory_order_relaxed);
+        streamSummary.bufferedBytes.store(reassembler.bytesBuffered(), std::memory_order_relaxed);
+        streamSummary.flowsOpened.store(rs.flowsOpened, std::memory_order_relaxed);
+        streamSummary.flowsClosed.store(rs.flowsClosed, std::memory_order_relaxed);
+        streamSummary.flowsEvicted.store(rs.flowsEvicted, std::memory_order_relaxed);
+        streamSummary.bytesDelivered.store(rs.bytesDelivered, std::memory_order_relaxed);
+        streamSummary.gapBytes.store(rs.gapBytes, std::memory_order_relaxed);
     }
 
-    void displayPackets() {
-        if (packetQueue.isEmpty()) {
+public:
+
+    void displayPackets(int page = 1) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
             std::cout << "\n⚠️  No packets captured yet.\n";
             return;
         }
         
-        std::cout << "\n📋 CURRENT PACKET LIST:\n";
-        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-        std::cout << "ID\tSource IP\t\tDestination IP\t\tProtocol\tSize\tTimestamp\n";
-        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        int pageSize = 50;
+        int pageCount = (snap.size() + pageSize - 1) / pageSize;
+        if (page < 1) page = 1;
+        if (page > pageCount) page = pageCount;
         
-        Queue<Packet> temp = packetQueue;
-        int count = 0;
-        int maxDisplay = 50;
+        size_t first = static_cast<size_t>(page - 1) * pageSize;
+        size_t last = std::min(first + pageSize, static_cast<size_t>(snap.size()));
         
-        while (!temp.isEmpty() && count < maxDisplay) {
-            Packet p = temp.front();
-            temp.dequeue();
-            
-            std::cout << p.id << "\t"
-                      << p.srcIP;
+        // Pages below firstIndex() come from the persistent store, whose
+        // evicted records are exactly store indexes [0, firstIndex()).
+        std::vector<Packet> older;
+        if (first < snap.firstIndex()) {
+            size_t skip = first, want = std::min(last, snap.firstIndex()) - first;
+            scanEvicted(snap, INT64_MIN, INT64_MAX, INT_MIN, INT_MAX, [&](const Packet& p) {
+                if (skip > 0) { skip--; return true; }
+                older.push_back(p);
+                return older.size() < want;
+            });
+            first = std::min(last, snap.firstIndex());
+        }
+        
+        std::cout << "\n📋 CURRENT PACKET LIST (Page " << page << " of " << pageCount << "):\n";
+        printPacketTable(snap, first, last, pageSize, older);
+        warnIfEvictedUnavailable(snap);
+        std::cout << "Total packets in queue: " << snap.size();
+        if (snap.firstIndex() > 0) std::cout << " (" << snap.firstIndex() << " on disk only)";
+        std::cout << "\n";
+    }
 
-            if (p.srcIP.length() < 16) std::cout << "\t";
-            std::cout << "\t" << p.dstIP;
-            if (p.dstIP.length() < 16) std::cout << "\t";
-            
-            std::cout << "\t" << p.protocol << "\t\t"
-                      << p.size << "\t"
-                      << p.getTimestampStr() << std::endl;
-            count++;
+    void displayPacketsByTime(double fromSec, double toSec) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
+            std::cout << "\n⚠️  No packets captured yet.\n";
+            return;
         }
         
-        if (!temp.isEmpty()) {
-            std::cout << "... and " << (packetQueue.size() - maxDisplay) << " more packets\n";
+        int64_t fromUsec = static_cast<int64_t>(fromSec * 1000000);
+        int64_t toUsec = static_cast<int64_t>(toSec * 1000000);
+        size_t first = snap.lowerBoundTime(fromUsec);
+        size_t last = snap.upperBoundTime(toUsec);
+        if (last < first) last = first;
+        
+        std::vector<Packet> older;
+        size_t olderCount = 0;
+        scanEvicted(snap, fromUsec, toUsec, INT_MIN, INT_MAX, [&](const Packet& p) {
+            if (older.size() < 50) older.push_back(p);
+            olderCount++;
+            return true;
+        });
+        
+        std::cout << "\n📋 PACKETS " << std::fixed << std::setprecision(6)
+                  << fromSec << " → " << toSec << ":\n";
+        std::cout.unsetf(std::ios::floatfield);
+        printPacketTable(snap, first, last, 50, older, olderCount);
+        warnIfEvictedUnavailable(snap);
+        std::cout << "Packets in range: " << olderCount + (last - first) << "\n";
+    }
+
+    void displayPacketsById(int fromId, int toId) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
+            std::cout << "\n⚠️  No packets captured yet.\n";
+            return;
         }
         
-        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-        std::cout << "Total packets in queue: " << packetQueue.size() << "\n";
+        size_t first = snap.lowerBoundId(fromId);
+        size_t last = toId == INT32_MAX ? snap.size() : snap.lowerBoundId(toId + 1);
+        if (last < first) last = first;
+        
+        std::vector<Packet> older;
+        size_t olderCount = 0;
+        scanEvicted(snap, INT64_MIN, INT64_MAX, fromId, toId, [&](const Packet& p) {
+            if (older.size() < 50) older.push_back(p);
+            olderCount++;
+            return true;
+        });
+        
+        std::cout << "\n📋 PACKETS WITH ID " << fromId << " → " << toId << ":\n";
+        printPacketTable(snap, first, last, 50, older, olderCount);
+        warnIfEvictedUnavailable(snap);
+        std::cout << "Packets in range: " << olderCount + (last - first) << "\n";
     }
 
     void displayPacketDetails(int packetId) {
-        if (packetQueue.isEmpty()) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
             std::cout << "\n⚠️  No packets in queue.\n";
             return;
         }
         
-        Queue<Packet> temp = packetQueue;
-        bool found = false;
-        
-        while (!temp.isEmpty()) {
-            Packet p = temp.front();
-            temp.dequeue();
-            
-            if (p.id == packetId) {
-                analyzer.displayPacketLayers(p);
-                found = true;
-                break;
-            }
+        const Packet* found = snap.findById(packetId);
+        Packet p;
+        bool onDisk = false;
+        if (!found) {
+            scanEvicted(snap, INT64_MIN, INT64_MAX, packetId, packetId, [&](const Packet& stored) {
+                p = stored;
+                onDisk = true;
+                return false;
+            });
+        }
+        if (found || onDisk) {
+            // Separate analyzer: the capture thread may be using `analyzer`.
+            PacketAnalyzer viewer;
+            if (found) p = *found;
+            inflater.inflate(p);
+            viewer.dissect(p);
+            viewer.displayPacketDetails(p);
+            return;
         }
         
-        if (!found) {
-            std::cout << "\n⚠️  Packet with ID " << packetId << " not found.\n";
-            std::cout << "Available packet IDs: ";
-
-            Queue<Packet> temp2 = packetQueue;
-            int showCount = 0;
-            while (!temp2.isEmpty() && showCount < 10) {
-                std::cout << temp2.front().id;
-                temp2.dequeue();
-                showCount++;
-                if (!temp2.isEmpty() && showCount < 10) std::cout << ", ";
-            }
-            if (packetQueue.size() > 10) {
-                std::cout << "... (total: " << packetQueue.size() << " packets)";
-            }
-            std::cout << "\n";
+        std::cout << "\n⚠️  Packet with ID " << packetId << " not found.\n";
+        warnIfEvictedUnavailable(snap);
+        std::cout << "Available packet IDs: ";
+
+        size_t showCount = std::min<size_t>(snap.size() - snap.firstIndex(), 10);
+        for (size_t i = 0; i < showCount; i++) {
+            std::cout << snap.at(snap.firstIndex() + i).id;
+            if (i + 1 < showCount) std::cout << ", ";
+        }
+        if (snap.size() > 10) {
+            std::cout << "... (total: " << snap.size() << " packets)";
         }
+        std::cout << "\n";
     }
 
     void filterPackets(const std::string& src, const std::string& dst) {
-        if (packetQueue.isEmpty()) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
             std::cout << "\n⚠️  No packets to filter. Please capture packets first.\n";
             return;
         }
@@ -183,46 +807,700 @@ public:
         std::cout << "\n🔎 FILTERING PACKETS: " << src << " → " << dst << "\n";
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
         
-        Queue<Packet> temp = packetQueue;
         int matchCount = 0;
         int skippedOversized = 0;
-        int checkedCount = 0;
         oversizedCount = 0;
       
         filteredQueue.clear();
+        
+        // "*" matches any address. Candidates come from the metadata
+        // columns; only they are checked against the address strings
+        // (IPv6 keys are hashes) and copied to the replay list.
+        ColumnFilter::AddressQuery query;
+        query.anySrc = (src == "*");
+        query.anyDst = (dst == "*");
+        query.srcKey = Packet::addressKey(src);
+        query.dstKey = Packet::addressKey(dst);
+        
+        // Packets no longer in memory are searched in the persistent
+        // store first (its bloom filters answer exact address pairs).
+        size_t olderMatches = 0;
+        if (snap.firstIndex() > 0) {
+            const PacketStore::Evicted& ev = snap.evictedRange();
+            auto check = [&](const Packet& p) {
+                if ((!query.anySrc && p.srcIP != src) || (!query.anyDst && p.dstIP != dst)) return true;
+                if (admitFiltered(p, skippedOversized)) matchCount++;
+                olderMatches++;
+                return true;
+            };
+            if (!query.anySrc && !query.anyDst) {
+                diskStore.scanAddressPair(src, dst, [&](const SegmentStore::RecordView& rec) {
+                    if (rec.header->id < ev.minId || rec.header->id > ev.maxId ||
+                        rec.header->tsUsec < ev.minTs || rec.header->tsUsec > ev.maxTs) return true;
+                    return check(SegmentStore::toPacket(rec));
+                });
+            } else {
+                scanEvicted(snap, INT64_MIN, INT64_MAX, INT_MIN, INT_MAX, check);
+            }
+        }
+        
+        auto scanStart = std::chrono::steady_clock::now();
+        // While the capture thread is pinned, the scan (this thread
+        // included) keeps off its CPU.
+        cpu_set_t savedAffinity, scanCpus;
+        bool moved = captureCpu >= 0 && CaptureTuning::saveAffinity(savedAffinity) &&
+                     CaptureTuning::cpusExcept(captureCpu, scanCpus) &&
+                     CaptureTuning::pinThread(pthread_self(), scanCpus);
+        ThreadPool& pool = filterThreads();
+        std::vector<uint32_t> selection = ColumnFilter::select(snap, query, pool);
+        if (moved) CaptureTuning::restoreAffinity(savedAffinity);
+        double scanMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanStart).count();
    
-        while (!temp.isEmpty()) {
-            Packet p = temp.front();
-            temp.dequeue();
-            checkedCount++;
-
-            if (p.srcIP == src && p.dstIP == dst) {
-                if (p.size > 1500) {
-                    oversizedCount++;
-                    if (oversizedCount > oversizedThreshold) {
-                        skippedOversized++;
-                        std::cout << "⚠️  Skipping oversized packet " << p.id 
-                                  << " (Size: " << p.size << " bytes)\n";
+        for (size_t i = 0; i < selection.size(); i++) {
+            const Packet& p = snap.at(selection[i]);
+            if ((!query.anySrc && p.srcIP != src) || (!query.anyDst && p.dstIP != dst)) continue;
+            if (admitFiltered(p, skippedOversized)) matchCount++;
+        }
+        
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "Checked " << snap.size() - snap.firstIndex() << " packets in memory in "
+                  << std::fixed << std::setprecision(2) << scanMs << " ms (" << pool.size()
+                  << (pool.size() == 1 ? " thread)\n" : " threads)\n");
+        std::cout.unsetf(std::ios::floatfield);
+        if (snap.firstIndex() > 0 && diskStore.isOpen()) {
+            std::cout << "Searched the persistent store for the " << snap.firstIndex() << " older packets ("
+                      << olderMatches << " matched)\n";
+        }
+        warnIfEvictedUnavailable(snap);
+        std::cout << "✅ Filtered " << matchCount << " matching packets\n";
+        if (skippedOversized > 0) {
+            std::cout << "⚠️  Skipped " << skippedOversized << " oversized packets\n";
+        }
+        if (matchCount == 0) {
+            std::cout << "\n💡 TIP: Use option 2 to see available IPs in captured packets\n";
+        }
+    }
+
+    // Registers a filter that collects matching packets while they are
+    // captured, so its view needs no rescan later (see StandingFilter).
+    void addStandingFilter(const std::string& src, const std::string& dst) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        standingFilters.push_back(std::unique_ptr<StandingFilter>(
+            new StandingFilter(src, dst, oversizedThreshold, PacketStore::Snapshot(packetQueue).generation())));
+        std::cout << "✅ Standing filter #" << standingFilters.size() << " registered: "
+                  << src << " → " << dst << "\n";
+        std::cout << "   Packets are matched as they are captured from now on\n";
+    }
+
+    void removeStandingFilter(int number) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (number < 1 || number > static_cast<int>(standingFilters.size())) {
+            std::cout << "❌ No standing filter #" << number << "\n";
+            return;
+        }
+        standingFilters.erase(standingFilters.begin() + (number - 1));
+        std::cout << "✅ Standing filter #" << number << " removed\n";
+    }
+
+    void displayStandingFilters() {
+        if (standingFilters.empty()) {
+            std::cout << "\n⚠️  No standing filters registered.\n";
+            return;
+        }
+        
+        uint64_t generation = PacketStore::Snapshot(packetQueue).generation();
+        std::cout << "\n📌 STANDING FILTERS:\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        for (size_t i = 0; i < standingFilters.size(); i++) {
+            const StandingFilter& f = *standingFilters[i];
+            StandingFilter::Snapshot matches(f);
+            std::cout << "  #" << (i + 1) << "  " << f.source() << " → " << f.destination() << "  |  ";
+            if (matches.generation() != generation) {
+                std::cout << "0 matched (earlier matches were cleared)\n";
+                continue;
+            }
+            std::cout << matches.size() << " matched";
+            if (matches.skipped() > 0) std::cout << ", " << matches.skipped() << " oversized skipped";
+            std::cout << "\n";
+        }
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    }
+
+    // Makes a standing filter's matches the replay list. Works during a
+    // capture too; the list holds the matches found so far.
+    void useStandingFilter(int number) {
+        if (number < 1 || number > static_cast<int>(standingFilters.size())) {
+            std::cout << "❌ No standing filter #" << number << "\n";
+            return;
+        }
+        const StandingFilter& f = *standingFilters[number - 1];
+        
+        // Packets still in memory are copied once from the store by index;
+        // evicted ones are read back from the persistent store by ID.
+        StandingFilter::Snapshot matches(f);
+        PacketStore::Snapshot snap(packetQueue);
+        if (matches.generation() != snap.generation()) {
+            std::cout << "\n⚠️  Standing filter #" << number << " has no matches since the captured packets "
+                      << "were cleared; the replay list is unchanged.\n";
+            return;
+        }
+        
+        filteredQueue.clear();
+        size_t i = 0, n = matches.size(), unavailable = 0;
+        size_t evicted = 0;
+        while (evicted < n && matches.index(evicted) < snap.firstIndex()) evicted++;
+        if (evicted > 0) {
+            scanEvicted(snap, INT64_MIN, INT64_MAX, matches.id(0), matches.id(evicted - 1), [&](const Packet& p) {
+                while (i < evicted && matches.id(i) < p.id) {
+                    unavailable++;
+                    i++;
+                }
+                if (i < evicted && matches.id(i) == p.id) {
+                    filteredQueue.enqueue(p);
+                    i++;
+                }
+                return i < evicted;
+            });
+            unavailable += evicted - i;
+            i = evicted;
+        }
+        for (; i < n; i++) filteredQueue.enqueue(snap.at(matches.index(i)));
+        
+        std::cout << "✅ Replay list loaded with " << filteredQueue.size() << " packets from standing filter #"
+                  << number << " (" << f.source() << " → " << f.destination() << ")\n";
+        if (matches.skipped() > 0) {
+            std::cout << "⚠️  Skipped " << matches.skipped() << " oversized packets\n";
+        }
+        if (unavailable > 0) {
+            std::cout << "⚠️  " << unavailable << " older matches could not be read from the persistent store"
+                      << (diskStore.isOpen() ? "\n" : " (it is closed)\n");
+        }
+    }
+
+    // Drives the capture pipeline from a TrafficGenerator at a rate that
+    // doubles every step from startPps up to maxPps. A producer thread
+    // offers frames into a bounded ring that stands in for the socket
+    // receive buffer; whatever does not fit is counted as dropped, exactly
+    // as the kernel would drop it. The ramp stops early once a step loses
+    // more than 10% of its frames.
+    void runLoadTest(const TrafficGenerator::Config& config, int startPps, int maxPps, int stepSeconds) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (startPps <= 0 || maxPps < startPps || stepSeconds <= 0) {
+            std::cout << "❌ Invalid load test parameters\n";
+            return;
+        }
+        
+        struct Step {
+            int targetPps;
+            uint64_t offered;
+            uint64_t dropped;
+            uint64_t ingested;
+            uint64_t shed;
+            uint64_t duplicates;
+        };
+        struct Item {
+            uint32_t frame;
+            uint32_t step;
+        };
+        
+        std::vector<Step> steps;
+        for (int64_t rate = startPps; ; rate *= 2) {
+            Step st = { static_cast<int>(std::min<int64_t>(rate, maxPps)), 0, 0, 0, 0, 0 };
+            steps.push_back(st);
+            if (rate >= maxPps) break;
+        }
+        
+        int syntheticPps = trafficConfig.pps;       // the ramp sets its own rates
+        trafficConfig = config;
+        trafficConfig.pps = syntheticPps;
+        TrafficGenerator generator(config);
+        SpscRing<Item> ring(4096);
+        std::atomic<bool> producing(true);
+        size_t stepsRun = 0;
+        
+        std::cout << "\n🚀 SYNTHETIC LOAD TEST: " << startPps << " → " << maxPps << " pps, "
+                  << stepSeconds << " s per step, " << generator.getConfig().flows << " flows\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        
+        capturing = true;
+        analyzer.setVerbose(false);
+        int firstId = nextPacketId;
+        
+        std::thread producer([&]() {
+            uint32_t next = 0;
+            uint32_t templates = static_cast<uint32_t>(generator.templateCount());
+            for (size_t si = 0; si < steps.size(); si++) {
+                Step& st = steps[si];
+                auto start = std::chrono::steady_clock::now();
+                stepsRun = si + 1;
+                for (;;) {
+                    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (elapsed >= stepSeconds) break;
+                    uint64_t due = static_cast<uint64_t>(elapsed * st.targetPps);
+                    if (st.offered >= due) {
+                        std::this_thread::sleep_for(std::chrono::microseconds(50));
                         continue;
                     }
+                    for (; st.offered < due; st.offered++) {
+                        Item item = { next, static_cast<uint32_t>(si) };
+                        if (!ring.tryPush(item)) st.dropped++;
+                        if (++next == templates) next = 0;
+                    }
+                }
+                std::cout << "   " << st.targetPps << " pps step done (" << st.dropped << " dropped)\n" << std::flush;
+                if (st.dropped * 10 > st.offered) break;
+            }
+            producing = false;
+        });
+        
+        auto nextExpiry = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+        uint64_t popped = 0;
+        for (;;) {
+            Item item;
+            if (ring.tryPop(item)) {
+                size_t len;
+                const unsigned char* frame = generator.frame(item.frame, len);
+                // A frame that was not stored was either shed by overload
+                // control or dropped as a duplicate.
+                uint64_t shedBefore = overload.packetsShed();
+                if (ingestFrame(frame, len)) {
+                    steps[item.step].ingested++;
+                } else if (overload.packetsShed() != shedBefore) {
+                    steps[item.step].shed++;
+                } else {
+                    steps[item.step].duplicates++;
                 }
+                if ((++popped & 255) == 0) {
+                    overload.observe(0, static_cast<double>(ring.size()) / ring.capacity(), steadyUsec());
+                }
+            } else if (!producing) {
+                if (ring.size() == 0) break;
+            } else {
+                std::this_thread::yield();
+            }
+            if (reassemblyEnabled && std::chrono::steady_clock::now() >= nextExpiry) {
+                expireStreams();
+                nextExpiry += std::chrono::seconds(1);
+            }
+        }
+        producer.join();
+        
+        if (reassemblyEnabled) {
+            publishStreamSummary();
+            streamDumper.flush();
+        }
+        analyzer.setVerbose(true);
+        capturing = false;
+        
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "Target pps\tOffered\t\tStored/s\tShed\tDups\tDropped\tDrop %\n";
+        int sustained = 0;
+        int dropPoint = 0;
+        for (size_t i = 0; i < stepsRun; i++) {
+            const Step& st = steps[i];
+            double dropPct = st.offered ? 100.0 * st.dropped / st.offered : 0.0;
+            std::cout << st.targetPps << "\t\t" << st.offered << "\t\t"
+                      << st.ingested / stepSeconds << "\t\t" << st.shed << "\t" << st.duplicates << "\t" << st.dropped << "\t"
+                      << std::fixed << std::setprecision(2) << dropPct << "\n";
+            std::cout.unsetf(std::ios::floatfield);
+            if (dropPct < 0.1 && !dropPoint) sustained = st.targetPps;
+            if (dropPct >= 0.1 && !dropPoint) dropPoint = st.targetPps;
+        }
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        if (sustained) {
+            std::cout << "✅ Sustained without loss: " << sustained << " pps\n";
+        } else {
+            std::cout << "⚠️  Frames were dropped even at the starting rate\n";
+        }
+        if (dropPoint) {
+            std::cout << "⚠️  Drops start at: " << dropPoint << " pps\n";
+        } else {
+            std::cout << "✅ No drops up to " << steps[stepsRun - 1].targetPps << " pps\n";
+        }
+        std::cout << "📦 Stored packets " << firstId << " → " << (nextPacketId - 1)
+                  << " (filter and replay them as usual)\n";
+    }
+
+    void setTcpReassembly(bool enabled) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        reassemblyEnabled = enabled;
+        if (!enabled) reassembler.clear();
+        std::cout << (enabled ? "✅ TCP stream reassembly enabled\n" : "✅ TCP stream reassembly disabled\n");
+    }
+
+    // Memory bounds of the reassembler: buffered out-of-order bytes per
+    // direction and in total, tracked flows, and the idle time after which
+    // a flow is evicted.
+    void setReassemblyLimits(size_t perFlowKB, size_t totalMB, size_t maxFlows, int idleSeconds) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (perFlowKB == 0 || totalMB == 0 || maxFlows == 0 || idleSeconds <= 0) {
+            std::cout << "❌ Invalid reassembly limits\n";
+            return;
+        }
+        reassembler.setLimits(perFlowKB * 1024, totalMB * 1024 * 1024, maxFlows, idleSeconds);
+        std::cout << "✅ Reassembly limits: " << perFlowKB << " KB per connection, " << totalMB << " MB total, "
+                  << maxFlows << " flows, " << idleSeconds << " s idle timeout\n";
+    }
 
-                filteredQueue.enqueue(p);
-                matchCount++;
-                std::cout << "✓ Matched packet " << p.id 
-                          << " | Size: " << p.size 
-                          << " | Protocol: " << p.protocol << "\n";
+    // Saves every reassembled stream under `dir` (see StreamDumper); "-"
+    // stops saving.
+    void setStreamDump(const std::string& dir) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (dir == "-") {
+            streamDumper.close();
+            reassembler.setCallback(TcpReassembler::StreamCallback());
+            return;
+        }
+        if (!streamDumper.open(dir)) {
+            std::cout << "❌ Cannot write streams to " << dir << ": " << strerror(errno) << "\n";
+            reassembler.setCallback(TcpReassembler::StreamCallback());
+            return;
+        }
+        StreamDumper* dumper = &streamDumper;
+        reassembler.setCallback([dumper](const TcpReassembler::StreamInfo& info, const unsigned char* data, size_t len) {
+            dumper->write(info, data, len);
+        });
+        std::cout << "✅ Reassembled streams are saved to " << dir << " (one file per direction)\n";
+    }
+
+    // Keeps payloads of older packets compressed in memory. Headers and
+    // metadata stay as they are, so listing and filtering are unaffected;
+    // packet details and replay decompress on demand.
+    void setCompression(bool enabled) {
+        if (enabled == compressionEnabled) return;
+        compressionEnabled = enabled;
+        if (enabled) {
+            compressThread = std::thread(&NetworkMonitor::compressionLoop, this);
+            std::cout << "✅ In-memory payload compression enabled\n";
+        } else {
+            if (compressThread.joinable()) compressThread.join();
+            std::cout << "✅ In-memory payload compression disabled (compressed packets stay compressed)\n";
+        }
+    }
+
+    bool isCompressionEnabled() const {
+        return compressionEnabled;
+    }
+
+    // Low-latency capture settings: CPU for the capture loop and for the
+    // compression worker (-1 = unpinned), busy polling instead of sleeping
+    // in epoll_wait, and receive buffers on the NIC's NUMA node. Each
+    // capture is logged with its settings in the capture mode report.
+    void setCaptureTuning(int captureCpuIndex, int workerCpuIndex, bool busyPolling, bool numaLocal) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (captureCpuIndex >= cpus || workerCpuIndex >= cpus) {
+            std::cout << "❌ This host has CPUs 0-" << (cpus - 1) << " only\n";
+            return;
+        }
+        captureCpu = captureCpuIndex < 0 ? -1 : captureCpuIndex;
+        workerCpu = workerCpuIndex < 0 ? -1 : workerCpuIndex;
+        busyPoll = busyPolling;
+        numaBuffers = numaLocal;
+        filterPool.reset();         // rebuilt off the new capture CPU
+        
+        if (compressThread.joinable() && !CaptureTuning::pinThread(compressThread.native_handle(), workerCpu)) {
+            std::cout << "⚠️  Could not pin the compression worker to CPU " << workerCpu << "\n";
+        }
+        
+        int busyUsec = busyPoll ? 50 : 0;
+        for (size_t i = 0; i < sockets.size(); i++) {
+            if (setsockopt(sockets[i].fd, SOL_SOCKET, SO_BUSY_POLL, &busyUsec, sizeof(busyUsec)) < 0 && busyPoll) {
+                std::cout << "⚠️  SO_BUSY_POLL not available on " << sockets[i].name
+                          << " (" << strerror(errno) << "); spinning in user space only\n";
+            }
+        }
+        
+        std::cout << "✅ Capture mode: " << describeCaptureMode(numaBuffers) << "\n";
+        for (size_t i = 0; i < sockets.size(); i++) {
+            int node = CaptureTuning::nicNumaNode(sockets[i].name);
+            if (node < 0) {
+                std::cout << "   " << sockets[i].name << ": no NUMA node reported\n";
+            } else {
+                std::cout << "   " << sockets[i].name << ": NUMA node " << node
+                          << " (local CPUs " << CaptureTuning::nodeCpuList(node) << ")\n";
             }
         }
+    }
+
+    void displayCaptureModeReport() {
+        std::lock_guard<std::mutex> lock(captureRunsLock);
+        if (captureRuns.empty()) {
+            std::cout << "\n⚠️  No captures finished yet.\n";
+            return;
+        }
+        
+        std::cout << "\n📊 DROPS BY CAPTURE MODE:\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "Mode\t\t\t\t\tSeconds\tPackets\t\tKernel Drops\tShed\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        for (size_t i = 0; i < captureRuns.size(); i++) {
+            const CaptureRun& r = captureRuns[i];
+            std::cout << std::left << std::setw(40) << r.mode << std::right << "\t"
+                      << r.seconds << "\t" << r.packets << "\t\t" << r.kernelDrops << "\t\t" << r.shed << "\n";
+        }
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    }
+
+    // Under overload the capture loop keeps only a sample of the traffic
+    // instead of letting the kernel drop at random; see OverloadController.
+    void setOverloadControl(OverloadController::Mode mode) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        overload.setMode(mode);
+        std::cout << "✅ Overload control: " << OverloadController::modeName(mode) << "\n";
+    }
+
+    // Loads byte signatures (one per line, see SignatureScanner::parseLine)
+    // that every captured TCP/UDP payload is scanned for from now on.
+    // "off" stops scanning.
+    void loadSignatures(const std::string& path) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        if (path == "off") {
+            scanner.reset();
+            std::cout << "✅ Signature scanning disabled\n";
+            return;
+        }
+        
+        std::ifstream in(path.c_str());
+        if (!in) {
+            std::cout << "❌ Cannot open signature file " << path << "\n";
+            return;
+        }
+        std::shared_ptr<SignatureScanner> compiled(new SignatureScanner());
+        std::string line, name, bytes;
+        while (std::getline(in, line)) {
+            if (SignatureScanner::parseLine(line, name, bytes)) compiled->addPattern(bytes, name);
+        }
+        if (compiled->patternCount() == 0) {
+            std::cout << "⚠️  No signatures found in " << path << "\n";
+            return;
+        }
+        compiled->compile();
+        
+        signatureCounts.reset(new std::atomic<uint64_t>[compiled->patternCount()]);
+        for (size_t i = 0; i < compiled->patternCount(); i++) signatureCounts[i].store(0);
+        scannedPackets = 0;
+        scannedBytes = 0;
+        flaggedPackets = 0;
+        scanner = compiled;
+        
+        std::cout << "✅ Loaded " << scanner->patternCount() << " signatures ("
+                  << scanner->stateCount() << " automaton states, "
+                  << scanner->alphabetSize() << " byte classes)\n";
+        std::cout << "   Payloads of new captures are scanned as they arrive\n";
+    }
+
+    // Moves packets whose payload matched a signature (any signature if
+    // signatureId < 0) to the replay list.
+    void filterSignatureMatches(int signatureId) {
+        PacketStore::Snapshot snap(packetQueue);
+        if (snap.isEmpty()) {
+            std::cout << "\n⚠️  No packets to filter. Please capture packets first.\n";
+            return;
+        }
+        
+        std::cout << "\n🔎 FILTERING PACKETS WITH SIGNATURE MATCHES";
+        if (signatureId >= 0) std::cout << " (#" << signatureId << ")";
+        std::cout << "\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        
+        int matchCount = 0;
+        int skippedOversized = 0;
+        oversizedCount = 0;
+        
+        filteredQueue.clear();
+        
+        for (size_t i = snap.firstIndex(); i < static_cast<size_t>(snap.size()); i++) {
+            const Packet& p = snap.at(i);
+            if (p.signatureHits == 0) continue;
+            if (signatureId >= 0 && p.firstSignature != signatureId && !payloadContains(p, signatureId)) continue;
+            if (admitFiltered(p, skippedOversized)) matchCount++;
+        }
         
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-        std::cout << "Checked " << checkedCount << " packets\n";
         std::cout << "✅ Filtered " << matchCount << " matching packets\n";
         if (skippedOversized > 0) {
             std::cout << "⚠️  Skipped " << skippedOversized << " oversized packets\n";
         }
-        if (matchCount == 0) {
-            std::cout << "\n💡 TIP: Use option 2 to see available IPs in captured packets\n";
+        // The disk store does not record signature matches.
+        if (snap.firstIndex() > 0) {
+            std::cout << "⚠️  The " << snap.firstIndex() << " oldest packets are no longer in memory "
+                      << "and were not checked\n";
+        }
+    }
+
+    // Packets only record their first match; a filter on any other
+    // signature re-scans the (few) flagged payloads.
+    bool payloadContains(const Packet& packet, int signatureId) {
+        if (!scanner || signatureId >= static_cast<int>(scanner->patternCount())) return false;
+        Packet p = packet;
+        inflater.inflate(p);
+        size_t len = scannedLength(p);
+        if (len == 0) return false;
+        
+        bool found = false;
+        scanner->scan(p.data.data() + p.payloadOffset, len,
+                      [&](uint32_t id, size_t) { if (static_cast<int>(id) == signatureId) found = true; });
+        return found;
+    }
+
+    // Duplicate frames (same bytes apart from MACs, TTL/hop limit and
+    // checksums) seen within `windowMs` of each other are counted and
+    // dropped before they are dissected or stored.
+    void setDeduplication(bool enabled, int windowMs = 20) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        dedupEnabled = enabled;
+        deduplicator.setWindow(windowMs);
+        deduplicator.clear();
+        if (enabled) {
+            std::cout << "✅ Duplicate frame suppression enabled (" << windowMs << " ms window)\n";
+        } else {
+            std::cout << "✅ Duplicate frame suppression disabled\n";
+        }
+    }
+
+    bool isDeduplicationEnabled() const {
+        return dedupEnabled;
+    }
+
+    bool isTcpReassemblyEnabled() const {
+        return reassemblyEnabled;
+    }
+
+    // With memoryPackets > 0, packets beyond the newest `memoryPackets`
+    // are dropped from memory (a chunk at a time) once they are on disk;
+    // listings and filters read that older range back from the store.
+    void enablePersistentStore(const std::string& dir, size_t segmentMB, size_t memoryPackets = 0) {
+        if (capturing) {
+            std::cout << "\n⚠️  Stop the background capture first.\n";
+            return;
+        }
+        try {
+            diskStore.open(dir, segmentMB * 1024 * 1024);
+        } catch (const std::exception& e) {
+            std::cout << "❌ " << e.what() << "\n";
+            return;
+        }
+        std::cout << "✅ Persistent store opened at " << dir << " ("
+                  << diskStore.segmentCount() << " existing segments, "
+                  << diskStore.recordCount() << " packets)\n";
+        
+        // Packets captured before now go to disk as well, so any chunk
+        // can be evicted. Those already written to this directory are not
+        // written again.
+        if (dir != lastDiskDir) lastDiskId = 0;
+        lastDiskDir = dir;
+        size_t copied = 0;
+        {
+            PacketStore::Snapshot snap(packetQueue);
+            for (size_t i = snap.firstIndex(); i < static_cast<size_t>(snap.size()) && diskStore.isOpen(); i++) {
+                if (snap.at(i).id <= lastDiskId) continue;
+                Packet p = snap.at(i);
+                inflater.inflate(p);
+                storeOnDisk(p);
+                copied++;
+            }
+        }
+        if (copied > 0) std::cout << "   " << copied << " packets already captured were written to it\n";
+        if (!diskStore.isOpen()) return;
+        
+        memoryLimit = memoryPackets;
+        std::cout << "   New captures are appended in " << segmentMB << " MB segments\n";
+        if (memoryLimit > 0) {
+            size_t evicted = packetQueue.evictOldest(memoryLimit);
+            std::cout << "   Memory keeps the newest " << memoryLimit << " packets (plus up to "
+                      << PacketStore::kChunkSize << "); older ones are read from disk\n";
+            if (evicted > 0) std::cout << "   " << evicted << " packets moved out of memory\n";
+        }
+    }
+
+    void displayStoredPackets(double fromSec, double toSec) {
+        if (!diskStore.isOpen()) {
+            std::cout << "\n⚠️  Persistent store is not enabled.\n";
+            return;
+        }
+        
+        std::cout << "\n📋 STORED PACKETS " << std::fixed << std::setprecision(6)
+                  << fromSec << " → " << toSec << ":\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "ID\tSource IP\t\tDestination IP\t\tProtocol\tSize\tTimestamp\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        
+        int count = 0;
+        int maxDisplay = 50;
+        size_t mapped = diskStore.scanTimeRange(
+            static_cast<int64_t>(fromSec * 1000000), static_cast<int64_t>(toSec * 1000000),
+            [&](const SegmentStore::RecordView& rec) -> bool {
+                if (count < maxDisplay) printPacketRow(SegmentStore::toPacket(rec));
+                count++;
+                return true;
+            });
+        
+        if (count > maxDisplay) {
+            std::cout << "... and " << (count - maxDisplay) << " more packets\n";
+        }
+        
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "Packets in range: " << count << " (read " << mapped << " of "
+                  << diskStore.segmentCount() << " segments)\n";
+    }
+
+    void filterStoredPackets(const std::string& src, const std::string& dst) {
+        if (!diskStore.isOpen()) {
+            std::cout << "\n⚠️  Persistent store is not enabled.\n";
+            return;
+        }
+        
+        std::cout << "\n🔎 FILTERING STORED PACKETS: " << src << " → " << dst << "\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        
+        int matchCount = 0;
+        int skippedOversized = 0;
+        oversizedCount = 0;
+        
+        filteredQueue.clear();
+        
+        size_t mapped = diskStore.scanAddressPair(src, dst,
+            [&](const SegmentStore::RecordView& rec) -> bool {
+                if (admitFiltered(SegmentStore::toPacket(rec), skippedOversized)) matchCount++;
+                return true;
+            });
+        
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "Read " << mapped << " of " << diskStore.segmentCount() << " segments\n";
+        std::cout << "✅ Filtered " << matchCount << " matching packets\n";
+        if (skippedOversized > 0) {
+            std::cout << "⚠️  Skipped " << skippedOversized << " oversized packets\n";
         }
     }
 
@@ -268,12 +1546,13 @@ public:
         while (!filteredQueue.isEmpty()) {
             Packet p = filteredQueue.front();
             filteredQueue.dequeue();
+            inflater.inflate(p);
             
             int delay = p.size / 1000;
             std::cout << "⏳ Packet " << p.id << ": Delay " << delay << "ms... ";
             std::this_thread::sleep_for(std::chrono::milliseconds(delay));
 
-            ssize_t sent = send(sock, p.data.data(), p.size, 0);
+            ssize_t sent = transmit(p);
             
             if (sent < 0 || sent != static_cast<ssize_t>(p.size)) {
 
@@ -312,6 +1591,7 @@ public:
         while (!backupQueue.isEmpty()) {
             Packet p = backupQueue.front();
             backupQueue.dequeue();
+            inflater.inflate(p);
 
             if (!p.canRetry()) {
                 std::cout << "❌ Packet " << p.id << " exceeded max retries (2). Discarding.\n";
@@ -329,7 +1609,7 @@ public:
             std::cout << "... ";
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             
-            ssize_t sent = send(sock, p.data.data(), p.size, 0);
+            ssize_t sent = transmit(p);
             
             if (sent < 0 || sent != static_cast<ssize_t>(p.size)) {
                 std::cout << "❌ FAILED\n";
@@ -357,12 +1637,192 @@ public:
     void displayStatistics() {
         std::cout << "\n📊 Network Monitor Statistics:\n";
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
-        std::cout << "  Total Captured Packets: " << packetQueue.size() << "\n";
+        {
+            PacketStore::Snapshot snap(packetQueue);
+            std::cout << "  Total Captured Packets: " << snap.size();
+            if (snap.firstIndex() > 0) {
+                std::cout << " (" << snap.size() - snap.firstIndex() << " in memory, "
+                          << snap.firstIndex() << " only in the persistent store)";
+            }
+            std::cout << "\n";
+        }
         std::cout << "  Filtered Packets (replay list): " << filteredQueue.size() << "\n";
         std::cout << "  Backup Queue (failed): " << backupQueue.size() << "\n";
-        std::cout << "  Interface: " << interface << "\n";
+        if (sockets.empty()) {
+            std::cout << "  Interface: " << interface << " (generated traffic)\n";
+        }
+        for (size_t i = 0; i < sockets.size(); i++) {
+            std::cout << "  Interface: " << sockets[i].name << " (" << ingressCounts[i].load() << " packets received)\n";
+        }
+        if (capturing) {
+            std::cout << "  Capture: 🔴 running in background\n";
+        }
+        if (compressedChunks > 0) {
+            std::cout << "  Compressed Packets: " << compressedChunks.load() * PacketStore::kChunkSize
+                      << " (" << bytesBeforeCompression.load() / 1024 << " KB → "
+                      << bytesAfterCompression.load() / 1024 << " KB)\n";
+        }
+        if (overload.getMode() != OverloadController::Off || overload.droppedByKernel() > 0) {
+            std::cout << "  Overload Control: " << OverloadController::modeName(overload.getMode())
+                      << " (now 1-in-" << overload.sampleWeight()
+                      << ", peak 1-in-" << overload.highestLevel() << ")\n";
+            std::cout << "  Shed Packets: " << overload.packetsShed()
+                      << " | Kernel Drops: " << overload.droppedByKernel() << "\n";
+            std::cout << "  Estimated Traffic (sampling-adjusted): " << weightedPackets.load() << " packets\n";
+        }
+        if (scanner) {
+            std::cout << "  Signature Scanning: " << scanner->patternCount() << " signatures | "
+                      << scannedPackets.load() << " payloads (" << scannedBytes.load() / 1024 << " KB) scanned | "
+                      << flaggedPackets.load() << " flagged\n";
+            
+            // Five most frequent signatures.
+            std::vector<std::pair<uint64_t, uint32_t> > top;
+            for (uint32_t i = 0; i < scanner->patternCount(); i++) {
+                uint64_t n = signatureCounts[i].load(std::memory_order_relaxed);
+                if (n > 0) top.push_back(std::make_pair(n, i));
+            }
+            size_t shown = std::min<size_t>(top.size(), 5);
+            std::partial_sort(top.begin(), top.begin() + shown, top.end(),
+                              std::greater<std::pair<uint64_t, uint32_t> >());
+            for (size_t i = 0; i < shown; i++) {
+                std::cout << "    #" << top[i].second << " " << scanner->patternName(top[i].second)
+                          << ": " << top[i].first << " matches\n";
+            }
+        }
+        if (!standingFilters.empty()) {
+            uint64_t total = 0;
+            uint64_t generation = PacketStore::Snapshot(packetQueue).generation();
+            for (size_t i = 0; i < standingFilters.size(); i++) {
+                StandingFilter::Snapshot matches(*standingFilters[i]);
+                if (matches.generation() == generation) total += matches.size();
+            }
+            std::cout << "  Standing Filters: " << standingFilters.size() << " (" << total << " packets matched)\n";
+        }
+        if (dedupEnabled || duplicateFrames > 0) {
+            std::cout << "  Duplicate Frames Dropped: " << duplicateFrames.load() << "\n";
+        }
+        if (reassemblyEnabled) {
+            const StreamSummary& ss = streamSummary;
+            std::cout << "  TCP Streams: " << ss.activeFlows.load() << " active | "
+                      << ss.flowsOpened.load() << " opened | " << ss.flowsClosed.load() << " closed | "
+                      << ss.flowsEvicted.load() << " evicted\n";
+            std::cout << "  TCP Bytes: " << ss.bytesDelivered.load() << " reassembled | "
+                      << ss.bufferedBytes.load() << " buffered | "
+                      << ss.gapBytes.load() << " lost in gaps\n";
+            if (streamDumper.isOpen()) {
+                std::cout << "  Saved Streams: " << streamDumper.fileCount() << " files ("
+                          << streamDumper.bytes() / 1024 << " KB) in " << streamDumper.getDirectory();
+                if (streamDumper.errors() > 0) std::cout << " | ❌ " << streamDumper.errors() << " write errors";
+                std::cout << "\n";
+            }
+        }
+        if (diskStore.isOpen()) {
+            std::cout << "  Persistent Store: " << diskStore.recordCount() << " packets in "
+                      << diskStore.segmentCount() << " segments ("
+                      << diskStore.bytesOnDisk() / 1024 << " KB) at " << diskStore.getDirectory() << "\n";
+            if (memoryLimit > 0) std::cout << "  Memory Limit: newest " << memoryLimit << " packets\n";
+        }
         std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
     }
+
+private:
+    // Prints `older` (packets read back from disk, `olderCount` in the
+    // range) ahead of store indexes [first, last), at most maxDisplay rows.
+    void printPacketTable(const PacketStore::Snapshot& snap, size_t first, size_t last, size_t maxDisplay,
+                          const std::vector<Packet>& older = std::vector<Packet>(), size_t olderCount = 0) {
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        std::cout << "ID\tSource IP\t\tDestination IP\t\tProtocol\tSize\tTimestamp\n";
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+        
+        size_t fromDisk = std::min(older.size(), maxDisplay);
+        for (size_t i = 0; i < fromDisk; i++) {
+            printPacketRow(older[i]);
+        }
+        size_t shown = std::min(last, first + (maxDisplay - fromDisk));
+        for (size_t i = first; i < shown; i++) {
+            printPacketRow(snap.at(i));
+        }
+        size_t total = std::max(olderCount, older.size()) + (last - first);
+        size_t printed = fromDisk + (shown - first);
+        if (total > printed) {
+            std::cout << "... and " << (total - printed) << " more packets\n";
+        }
+        
+        std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━\n";
+    }
+
+    // Visits the packets evictOldest() dropped from the snapshot's view
+    // (store indexes below firstIndex()) that lie in the given time and ID
+    // ranges, read back from the persistent store in capture order. The
+    // evicted bounds keep out records of other sessions in the same
+    // directory. The visitor returns false to stop.
+    template <typename Visitor>
+    void scanEvicted(const PacketStore::Snapshot& snap, int64_t fromUsec, int64_t toUsec,
+                     int fromId, int toId, Visitor visit) {
+        const PacketStore::Evicted& ev = snap.evictedRange();
+        if (ev.count == 0) return;
+        fromId = std::max(fromId, ev.minId);
+        toId = std::min(toId, ev.maxId);
+        if (fromId > toId) return;
+        diskStore.scanTimeRange(std::max(fromUsec, ev.minTs), std::min(toUsec, ev.maxTs),
+            [&](const SegmentStore::RecordView& rec) {
+                if (rec.header->id < fromId) return true;
+                if (rec.header->id > toId) return false;
+                return visit(SegmentStore::toPacket(rec));
+            });
+    }
+
+    // Evicted packets can only be read while the store is open.
+    void warnIfEvictedUnavailable(const PacketStore::Snapshot& snap) {
+        if (snap.firstIndex() > 0 && !diskStore.isOpen()) {
+            std::cout << "⚠️  The " << snap.firstIndex() << " oldest packets are only in the persistent store, "
+                      << "which is closed; open it again (option 11) to include them\n";
+        }
+    }
+
+    void printPacketRow(const Packet& p) {
+        std::cout << p.id << "\t"
+                  << p.srcIP;
+
+        if (p.srcIP.length() < 16) std::cout << "\t";
+        std::cout << "\t" << p.dstIP;
+        if (p.dstIP.length() < 16) std::cout << "\t";
+        
+        std::cout << "\t" << p.protocol << "\t\t"
+                  << p.size << "\t"
+                  << p.getTimestampStr() << std::endl;
+    }
+
+    // One filter thread per CPU the capture thread is not pinned to.
+    ThreadPool& filterThreads() {
+        if (!filterPool) {
+            cpu_set_t cpus;
+            bool placed = CaptureTuning::cpusExcept(captureCpu, cpus);
+            filterPool.reset(new ThreadPool(placed ? CPU_COUNT(&cpus) : 0));
+            if (placed) filterPool->setAffinity(cpus);
+        }
+        return *filterPool;
+    }
+
+    // Applies the oversized-packet policy to a packet that matched a
+    // filter and moves it to the replay list if it is admitted.
+    bool admitFiltered(const Packet& p, int& skippedOversized) {
+        if (p.size > 1500) {
+            oversizedCount++;
+            if (oversizedCount > oversizedThreshold) {
+                skippedOversized++;
+                std::cout << "⚠️  Skipping oversized packet " << p.id 
+                          << " (Size: " << p.size << " bytes)\n";
+                return false;
+            }
+        }
+
+        filteredQueue.enqueue(p);
+        std::cout << "✓ Matched packet " << p.id 
+                  << " | Size: " << p.size 
+                  << " | Protocol: " << p.protocol << "\n";
+        return true;
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,186 @@
+#ifndef OVERLOAD_CONTROLLER_H
+#define OVERLOAD_CONTROLLER_H
+
+#include <net/ethernet.h>
+#include <netinet/in.h>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Sheds load in the capture loop before the kernel starts dropping on its
+// own. The loop reports backlog (how full its receive batches or ring are)
+// and kernel drop counts; when either shows the pipeline falling behind,
+// the controller halves the share of packets it admits (1-in-2, 1-in-4,
+// ... up to 1-in-kMaxLevel), and it doubles it again after a few calm
+// intervals.
+//
+// Packet sampling keeps every N-th frame. Flow sampling keeps the frames
+// whose 5-tuple hash is a multiple of N, so a flow is either kept whole or
+// dropped whole; since N is a power of two, the flows kept at 1-in-2N are
+// a subset of those kept at 1-in-N. Every admitted packet carries the N in
+// force (Packet::sampleWeight) so counts can be scaled back up.
+//
+// admit() and observe() run on the capture thread; the counters may be
+// read from any thread.
+class OverloadController {
+public:
+    enum Mode { Off, PacketSampling, FlowSampling };
+    enum { kMaxLevel = 64 };
+
+private:
+    Mode mode;
+    std::atomic<uint32_t> level;
+    uint64_t sequence;
+    int calmIntervals;
+
+    int64_t intervalStart;
+    uint64_t intervalDrops;
+    double intervalBacklog;
+
+    std::atomic<uint64_t> admitted;
+    std::atomic<uint64_t> shed;
+    std::atomic<uint64_t> kernelDrops;
+    std::atomic<uint32_t> peakLevel;
+
+public:
+    OverloadController() : mode(Off), level(1), sequence(0), calmIntervals(0), intervalStart(0),
+                           intervalDrops(0), intervalBacklog(0), admitted(0), shed(0),
+                           kernelDrops(0), peakLevel(1) {}
+
+    void setMode(Mode m) {
+        mode = m;
+        reset();
+    }
+
+    Mode getMode() const {
+        return mode;
+    }
+
+    static const char* modeName(Mode m) {
+        return m == PacketSampling ? "1-in-N packet sampling"
+             : m == FlowSampling ? "flow-hash sampling" : "off";
+    }
+
+    void reset() {
+        level = 1;
+        sequence = 0;
+        calmIntervals = 0;
+        intervalStart = 0;
+        intervalDrops = 0;
+        intervalBacklog = 0;
+        admitted = 0;
+        shed = 0;
+        kernelDrops = 0;
+        peakLevel = 1;
+    }
+
+    // Current sampling rate: one packet in this many is kept.
+    uint32_t sampleWeight() const {
+        return level.load(std::memory_order_relaxed);
+    }
+
+    uint64_t packetsAdmitted() const { return admitted.load(std::memory_order_relaxed); }
+    uint64_t packetsShed() const { return shed.load(std::memory_order_relaxed); }
+    uint64_t droppedByKernel() const { return kernelDrops.load(std::memory_order_relaxed); }
+    uint32_t highestLevel() const { return peakLevel.load(std::memory_order_relaxed); }
+
+    bool admit(const unsigned char* frame, size_t len) {
+        uint32_t n = level.load(std::memory_order_relaxed);
+        bool keep = true;
+        if (mode == PacketSampling && n > 1) {
+            keep = sequence++ % n == 0;
+        } else if (mode == FlowSampling && n > 1) {
+            keep = (flowHash(frame, len) & (n - 1)) == 0;
+        }
+        if (keep) {
+            admitted.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            shed.fetch_add(1, std::memory_order_relaxed);
+        }
+        return keep;
+    }
+
+    // Feeds one observation: frames the kernel dropped since the last
+    // call and the current backlog as a fraction of capacity (0..1).
+    // Decisions are taken once per 250 ms interval on the worst backlog
+    // seen in it.
+    void observe(uint64_t drops, double backlog, int64_t nowUsec) {
+        kernelDrops.fetch_add(drops, std::memory_order_relaxed);
+        intervalDrops += drops;
+        intervalBacklog = std::max(intervalBacklog, backlog);
+        if (intervalStart == 0) intervalStart = nowUsec;
+        if (nowUsec - intervalStart < 250000) return;
+
+        uint32_t n = level.load(std::memory_order_relaxed);
+        if (mode != Off && (intervalDrops > 0 || intervalBacklog > 0.75)) {
+            n = std::min<uint32_t>(n * 2, kMaxLevel);
+            calmIntervals = 0;
+        } else if (intervalBacklog < 0.25 && n > 1 && ++calmIntervals >= 4) {
+            n /= 2;
+            calmIntervals = 0;
+        }
+        level.store(n, std::memory_order_relaxed);
+        if (n > peakLevel.load(std::memory_order_relaxed)) peakLevel.store(n, std::memory_order_relaxed);
+
+        intervalStart = nowUsec;
+        intervalDrops = 0;
+        intervalBacklog = 0;
+    }
+
+    // Direction-independent hash of the IP addresses, protocol and ports,
+    // read straight from the frame (no dissection). Non-IP frames and
+    // later IPv4 fragments hash on what is available.
+    static uint32_t flowHash(const unsigned char* frame, size_t len) {
+        size_t l3 = sizeof(struct ether_header);
+        if (len < l3 + 20) return 0;
+        uint16_t etherType = static_cast<uint16_t>((frame[12] << 8) | frame[13]);
+
+        const unsigned char* ip = frame + l3;
+        const unsigned char* src;
+        const unsigned char* dst;
+        size_t addrLen, l4;
+        int proto;
+        bool ports;
+        if (etherType == ETHERTYPE_IP) {
+            src = ip + 12;
+            dst = ip + 16;
+            addrLen = 4;
+            proto = ip[9];
+            l4 = l3 + (ip[0] & 0x0f) * 4;
+            ports = (((ip[6] & 0x1f) << 8) | ip[7]) == 0;        // first fragment only
+        } else if (etherType == ETHERTYPE_IPV6 && len >= l3 + 40) {
+            src = ip + 8;
+            dst = ip + 24;
+            addrLen = 16;
+            proto = ip[6];
+            l4 = l3 + 40;
+            ports = true;
+        } else {
+            return etherType;
+        }
+
+        uint32_t sp = 0, dp = 0;
+        if (ports && (proto == IPPROTO_TCP || proto == IPPROTO_UDP) && len >= l4 + 4) {
+            sp = (frame[l4] << 8) | frame[l4 + 1];
+            dp = (frame[l4 + 2] << 8) | frame[l4 + 3];
+        }
+
+        uint32_t a = endpointHash(src, addrLen, sp);
+        uint32_t b = endpointHash(dst, addrLen, dp);
+        uint32_t h = std::min(a, b) * 0x9E3779B1u ^ std::max(a, b) ^ static_cast<uint32_t>(proto);
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        return h;
+    }
+
+private:
+    static uint32_t endpointHash(const unsigned char* addr, size_t len, uint32_t port) {
+        uint32_t h = 2166136261u ^ port;
+        for (size_t i = 0; i < len; i++) h = (h ^ addr[i]) * 16777619u;
+        return h;
+    }
+};
+
+#endif
\ No newline at end of file
@@ -4,9 +4,14 @@
 #include <string>
 #include <vector>
 #include <sys/time.h>
+#include <arpa/inet.h>
+#include <cstdint>
+#include <memory>
 #include <sstream>
 #include <iomanip>
 
+struct PayloadBlock;
+
 class Packet {
 public:
     int id;
@@ -17,15 +22,45 @@ public:
     std::string dstIP;
     std::string protocol;
     int retryCount;
+    int ifIndex;                // ingress interface (kernel index), 0 if unknown
+    uint32_t sampleWeight;      // packets this one stands for (1-in-N sampling)
+    
+    // Filled in by PacketAnalyzer::dissect for IP packets: fixed-size
+    // forms of the addresses and protocol for the store's metadata columns.
+    uint64_t srcKey;
+    uint64_t dstKey;
+    uint8_t ipProtocol;
+    
+    // Filled in by PacketAnalyzer::dissect for TCP/UDP packets.
+    uint16_t srcPort;
+    uint16_t dstPort;
+    uint32_t tcpSeq;
+    uint8_t tcpFlags;
+    size_t payloadOffset;
+    size_t payloadLength;
+    
+    // Set by the signature scanner when the L4 payload matched.
+    uint16_t signatureHits;
+    int32_t firstSignature;     // -1 if none
+    
+    // Set when the bytes after the headers were moved into a compressed
+    // block by PayloadCompressor; `data` then holds only the headers.
+    std::shared_ptr<const PayloadBlock> payloadBlock;
+    uint32_t blockSlot;
     
     Packet() : id(0), size(0), srcIP("Unknown"), dstIP("Unknown"), 
-               protocol("Unknown"), retryCount(0) {
+               protocol("Unknown"), retryCount(0), ifIndex(0), sampleWeight(1),
+               srcKey(0), dstKey(0), ipProtocol(0), srcPort(0), dstPort(0),
+               tcpSeq(0), tcpFlags(0), payloadOffset(0), payloadLength(0),
+               signatureHits(0), firstSignature(-1), blockSlot(0) {
         gettimeofday(&timestamp, nullptr);
     }
     
     Packet(int id, const unsigned char* buffer, size_t size)
         : id(id), size(size), data(buffer, buffer + size),
-          srcIP("Unknown"), dstIP("Unknown"), protocol("Unknown"), retryCount(0) {
+          srcIP("Unknown"), dstIP("Unknown"), protocol("Unknown"), retryCount(0), ifIndex(0),
+          sampleWeight(1), srcKey(0), dstKey(0), ipProtocol(0), srcPort(0), dstPort(0), tcpSeq(0), tcpFlags(0), payloadOffset(0), payloadLength(0),
+          signatureHits(0), firstSignature(-1), blockSlot(0) {
         gettimeofday(&timestamp, nullptr);
     }
     
@@ -40,6 +75,30 @@ public:
         return static_cast<int>(size / 1000);
     }
     
+    bool isCompressed() const {
+        return payloadBlock != nullptr;
+    }
+    
+    // 64-bit key of an IP address: IPv4 addresses map exactly (tagged so
+    // they cannot collide with IPv6 keys), IPv6 addresses are hashed.
+    // 0 means no address.
+    static uint64_t addressKey(const unsigned char* addr, size_t len) {
+        if (len == 4) {
+            return 0xFFFF00000000ULL | (static_cast<uint64_t>(addr[0]) << 24) | (addr[1] << 16) |
+                   (addr[2] << 8) | addr[3];
+        }
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < len; i++) h = (h ^ addr[i]) * 1099511628211ULL;
+        return h | (1ULL << 63);
+    }
+
+    static uint64_t addressKey(const std::string& text) {
+        unsigned char addr[16];
+        if (inet_pton(AF_INET, text.c_str(), addr) == 1) return addressKey(addr, 4);
+        if (inet_pton(AF_INET6, text.c_str(), addr) == 1) return addressKey(addr, 16);
+        return 0;
+    }
+    
     bool canRetry() const {
         return retryCount < 2;
     }
@@ -9,16 +9,28 @@
 #include <netinet/udp.h>
 #include <netinet/ether.h>
 #include <arpa/inet.h>
+#include <net/if.h>
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 class PacketAnalyzer {
+private:
+    bool verbose;
+
 public:
+    PacketAnalyzer() : verbose(true) {}
+
+    // Background and high-rate captures turn off the per-packet layer dump.
+    void setVerbose(bool enabled) {
+        verbose = enabled;
+    }
+
     void dissect(Packet& packet) {
         Stack<std::string> layers;
         
         if (packet.size < sizeof(struct ether_header)) {
-            std::cout << "Packet " << packet.id << " too small for Ethernet header\n";
+            if (verbose) std::cout << "Packet " << packet.id << " too small for Ethernet header\n";
             return;
         }
         
@@ -44,8 +56,13 @@ public:
             
             packet.srcIP = srcIP;
             packet.dstIP = dstIP;
+            packet.srcKey = Packet::addressKey(reinterpret_cast<const unsigned char*>(&iph->ip_src), 4);
+            packet.dstKey = Packet::addressKey(reinterpret_cast<const unsigned char*>(&iph->ip_dst), 4);
+            packet.ipProtocol = iph->ip_p;
             
             int iph_len = iph->ip_hl * 4;
+            size_t ipLen = ntohs(iph->ip_len);     // 0 on TSO/GRO frames
+            size_t end = ipLen ? std::min(packet.size, offset + ipLen) : packet.size;
             offset += iph_len;
 
             if (iph->ip_p == IPPROTO_TCP) {
@@ -55,6 +72,7 @@ public:
                 layers.push("UDP");
                 packet.protocol = "UDP";
             }
+            parseTransport(packet, iph->ip_p, offset, end);
             
         } else if (etherType == ETHERTYPE_IPV6) {
             layers.push("IPv6");
@@ -72,7 +90,11 @@ public:
             
             packet.srcIP = srcIP;
             packet.dstIP = dstIP;
+            packet.srcKey = Packet::addressKey(reinterpret_cast<const unsigned char*>(&ip6h->ip6_src), 16);
+            packet.dstKey = Packet::addressKey(reinterpret_cast<const unsigned char*>(&ip6h->ip6_dst), 16);
+            packet.ipProtocol = ip6h->ip6_nxt;
             
+            size_t end = std::min(packet.size, offset + sizeof(struct ip6_hdr) + ntohs(ip6h->ip6_plen));
             offset += sizeof(struct ip6_hdr);
             
             if (ip6h->ip6_nxt == IPPROTO_TCP) {
@@ -82,6 +104,7 @@ public:
                 layers.push("UDP");
                 packet.protocol = "UDP";
             }
+            parseTransport(packet, ip6h->ip6_nxt, offset, end);
         }
         
         displayLayers(packet.id, layers);
@@ -95,12 +118,55 @@ public:
         std::cout << "  Source IP: " << packet.srcIP << "\n";
         std::cout << "  Destination IP: " << packet.dstIP << "\n";
         std::cout << "  Protocol: " << packet.protocol << "\n";
+        if (packet.srcPort || packet.dstPort) {
+            std::cout << "  Ports: " << packet.srcPort << " → " << packet.dstPort << "\n";
+            std::cout << "  Payload: " << packet.payloadLength << " bytes\n";
+        }
+        char ifName[IF_NAMESIZE];
+        if (packet.ifIndex > 0 && if_indextoname(packet.ifIndex, ifName)) {
+            std::cout << "  Interface: " << ifName << "\n";
+        }
+        if (packet.signatureHits > 0) {
+            std::cout << "  Signature Matches: " << packet.signatureHits
+                      << " (first: #" << packet.firstSignature << ")\n";
+        }
+        if (packet.sampleWeight > 1) {
+            std::cout << "  Sampled: 1 in " << packet.sampleWeight << " packets kept\n";
+        }
         std::cout << "  Estimated Delay: " << packet.getEstimatedDelay() << " ms\n";
         std::cout << "═══════════════════════════════════════════\n";
     }
 
 private:
+    // Records ports, TCP sequence/flags and the L4 payload location.
+    // `end` is the end of the IP datagram, which excludes Ethernet padding.
+    void parseTransport(Packet& packet, int proto, size_t offset, size_t end) {
+        if (end < offset) return;
+        
+        if (proto == IPPROTO_TCP && end >= offset + sizeof(struct tcphdr)) {
+            const struct tcphdr* tcph = (const struct tcphdr*)(packet.data.data() + offset);
+            size_t hdrLen = tcph->th_off * 4;
+            if (hdrLen < sizeof(struct tcphdr) || offset + hdrLen > end) return;
+            packet.srcPort = ntohs(tcph->th_sport);
+            packet.dstPort = ntohs(tcph->th_dport);
+            packet.tcpSeq = ntohl(tcph->th_seq);
+            packet.tcpFlags = tcph->th_flags;
+            packet.payloadOffset = offset + hdrLen;
+            packet.payloadLength = end - packet.payloadOffset;
+        } else if (proto == IPPROTO_UDP && end >= offset + sizeof(struct udphdr)) {
+            const struct udphdr* udph = (const struct udphdr*)(packet.data.data() + offset);
+            packet.srcPort = ntohs(udph->uh_sport);
+            packet.dstPort = ntohs(udph->uh_dport);
+            packet.payloadOffset = offset + sizeof(struct udphdr);
+            packet.payloadLength = end - packet.payloadOffset;
+        } else {
+            packet.payloadOffset = offset;
+            packet.payloadLength = end - offset;
+        }
+    }
+
     void displayLayers(int packetId, Stack<std::string>& layers) {
+        if (!verbose) return;
         std::cout << "Packet " << packetId << " Layers: ";
         
         Stack<std::string> temp;
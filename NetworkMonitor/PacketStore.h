@@ -0,0 +1,402 @@
+#ifndef PACKET_STORE_H
+#define PACKET_STORE_H
+
+#include "Packet.h"
+#include "Epoch.h"
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+// In-memory capture history backed by a deque of fixed-size contiguous
+// chunks. Packets arrive in ID and timestamp order, so every chunk keeps
+// its min/max timestamp and ID; lookups binary-search the chunk directory
+// and then the one chunk that can hold the answer instead of walking a
+// linked list from the front.
+//
+// The capture thread appends while other threads read. Packets are never
+// modified once published: a writer fills the next slot and then bumps the
+// directory's published count, growing or clearing the store swaps in a new
+// directory, and replaced directories/chunks are freed through an
+// EpochManager once no Snapshot can still see them. Readers take no locks.
+// A full chunk may also be swapped for a compacted copy (payloads moved
+// into compressed blocks) by a background worker through replaceChunk().
+//
+// Next to its packets every chunk keeps their metadata as columns (one
+// contiguous array per field), so scans such as ColumnFilter read a few
+// bytes per packet instead of whole Packet objects.
+//
+// When the packets are also kept on disk, evictOldest() drops whole chunks
+// from the front to cap memory. Indexes stay stable: the store then holds
+// [firstIndex(), size()), and the evicted prefix is described by its ID
+// and time bounds so callers can fetch it from the disk store instead.
+class PacketStore {
+public:
+    enum { kChunkSize = 1024 };
+
+    struct Columns {
+        int64_t tsUsec[kChunkSize];
+        uint64_t srcKey[kChunkSize];    // Packet::addressKey
+        uint64_t dstKey[kChunkSize];
+        uint16_t srcPort[kChunkSize];
+        uint16_t dstPort[kChunkSize];
+        uint32_t size[kChunkSize];
+        uint8_t protocol[kChunkSize];   // IP protocol number
+    };
+
+private:
+    struct Chunk {
+        Packet* entries;
+        Columns* columns;
+        size_t filled;                  // writer side, for destruction
+        bool compacted;                 // fixed before the chunk is published
+        std::atomic<int64_t> minTs;
+        std::atomic<int64_t> maxTs;
+        std::atomic<int> minId;
+        std::atomic<int> maxId;
+
+        Chunk() : entries(static_cast<Packet*>(::operator new(sizeof(Packet) * kChunkSize))),
+                  columns(new Columns), filled(0), compacted(false), minTs(0), maxTs(0), minId(0), maxId(0) {}
+
+        ~Chunk() {
+            for (size_t i = 0; i < filled; i++) entries[i].~Packet();
+            ::operator delete(entries);
+            delete columns;
+        }
+    };
+
+    struct Directory {
+        std::atomic<Chunk*>* slots;
+        size_t capacity;
+        std::atomic<size_t> count;      // packets visible to readers
+        std::atomic<size_t> first;      // packets evicted from the front
+        std::atomic<int64_t> evictedMinTs;
+        std::atomic<int64_t> evictedMaxTs;
+        std::atomic<int> evictedMinId;
+        std::atomic<int> evictedMaxId;
+        uint64_t generation;            // bumped by clear()
+        bool ownsChunks;
+
+        Directory(size_t cap, uint64_t gen) : slots(new std::atomic<Chunk*>[cap]), capacity(cap),
+                                              count(0), first(0), evictedMinTs(0), evictedMaxTs(0),
+                                              evictedMinId(0), evictedMaxId(0), generation(gen), ownsChunks(false) {
+            for (size_t i = 0; i < cap; i++) slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~Directory() {
+            if (ownsChunks) {
+                size_t used = (count.load() + kChunkSize - 1) / kChunkSize;
+                for (size_t i = first.load() / kChunkSize; i < used; i++) delete slots[i].load();
+            }
+            delete[] slots;
+        }
+    };
+
+    std::atomic<Directory*> current;
+    std::mutex writeLock;               // serializes writers only
+    EpochManager epochs;
+
+public:
+    // The packets evictOldest() has dropped: store indexes [0, count).
+    struct Evicted {
+        size_t count;
+        int64_t minTs;
+        int64_t maxTs;
+        int minId;
+        int maxId;
+    };
+
+    // Consistent read-only view of the store at the moment it was taken.
+    // Packets appended afterwards are not visible through it; chunks
+    // evicted afterwards stay readable through it.
+    class Snapshot {
+    public:
+        explicit Snapshot(PacketStore& store)
+            : guard(store.epochs), dir(store.current.load()), count(0) {
+            // `first` before `count`, so first <= count.
+            evicted.count = dir->first.load(std::memory_order_acquire);
+            evicted.minTs = dir->evictedMinTs.load(std::memory_order_relaxed);
+            evicted.maxTs = dir->evictedMaxTs.load(std::memory_order_relaxed);
+            evicted.minId = dir->evictedMinId.load(std::memory_order_relaxed);
+            evicted.maxId = dir->evictedMaxId.load(std::memory_order_relaxed);
+            count = dir->count.load(std::memory_order_acquire);
+            // The upper bounds may already include a later eviction.
+            if (evicted.count < count) {
+                const Packet& oldest = at(evicted.count);
+                evicted.maxId = std::min(evicted.maxId, oldest.id - 1);
+                evicted.maxTs = std::min(evicted.maxTs, toUsec(oldest.timestamp));
+            }
+        }
+
+        const Packet& at(size_t index) const {
+            if (index >= count || index < evicted.count) throw std::out_of_range("PacketStore index out of range");
+            return chunk(index / kChunkSize)->entries[index % kChunkSize];
+        }
+
+        // First index still held in memory.
+        size_t firstIndex() const {
+            return evicted.count;
+        }
+
+        const Evicted& evictedRange() const {
+            return evicted;
+        }
+
+        bool isEmpty() const {
+            return count == 0;
+        }
+
+        int size() const {
+            return static_cast<int>(count);
+        }
+
+        // Index of the first packet with timestamp >= usec (size() if none).
+        size_t lowerBoundTime(int64_t usec) const {
+            size_t chunks = chunkCount();
+            size_t lo = firstChunk(), hi = chunks;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (chunk(mid)->maxTs.load(std::memory_order_relaxed) < usec) lo = mid + 1; else hi = mid;
+            }
+            if (lo == chunks) return count;
+            const Packet* e = chunk(lo)->entries;
+            size_t i = 0, n = entriesIn(lo);
+            while (i < n) {
+                size_t mid = i + (n - i) / 2;
+                if (toUsec(e[mid].timestamp) < usec) i = mid + 1; else n = mid;
+            }
+            return lo * kChunkSize + i;
+        }
+
+        // Index of the first packet with timestamp > usec (size() if none).
+        size_t upperBoundTime(int64_t usec) const {
+            return usec == INT64_MAX ? count : lowerBoundTime(usec + 1);
+        }
+
+        // Index of the first packet with ID >= id (size() if none).
+        size_t lowerBoundId(int id) const {
+            size_t chunks = chunkCount();
+            size_t lo = firstChunk(), hi = chunks;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (chunk(mid)->maxId.load(std::memory_order_relaxed) < id) lo = mid + 1; else hi = mid;
+            }
+            if (lo == chunks) return count;
+            const Packet* e = chunk(lo)->entries;
+            size_t i = 0, n = entriesIn(lo);
+            while (i < n) {
+                size_t mid = i + (n - i) / 2;
+                if (e[mid].id < id) i = mid + 1; else n = mid;
+            }
+            return lo * kChunkSize + i;
+        }
+
+        const Packet* findById(int id) const {
+            size_t index = lowerBoundId(id);
+            if (index < count && at(index).id == id) return &at(index);
+            return nullptr;
+        }
+
+        uint64_t generation() const {
+            return dir->generation;
+        }
+
+        size_t fullChunks() const {
+            return count / kChunkSize;
+        }
+
+        bool isChunkCompacted(size_t chunkIndex) const {
+            return chunk(chunkIndex)->compacted;
+        }
+
+        size_t chunkCount() const {
+            return (count + kChunkSize - 1) / kChunkSize;
+        }
+
+        size_t firstChunk() const {
+            return evicted.count / kChunkSize;
+        }
+
+        // Rows of the chunk visible in this snapshot.
+        size_t rowsIn(size_t chunkIndex) const {
+            return entriesIn(chunkIndex);
+        }
+
+        const Columns& columns(size_t chunkIndex) const {
+            return *chunk(chunkIndex)->columns;
+        }
+
+    private:
+        EpochManager::Guard guard;
+        Directory* dir;
+        size_t count;
+        Evicted evicted;
+
+        const Chunk* chunk(size_t i) const {
+            return dir->slots[i].load(std::memory_order_acquire);
+        }
+
+        size_t entriesIn(size_t chunkIndex) const {
+            return std::min(static_cast<size_t>(kChunkSize), count - chunkIndex * kChunkSize);
+        }
+
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+    };
+
+    PacketStore() : current(new Directory(64, 0)) {}
+
+    ~PacketStore() {
+        Directory* d = current.load();
+        d->ownsChunks = true;
+        delete d;
+    }
+
+    // Returns the packet's index; `generation`, if given, receives the
+    // generation it was stored under (see Snapshot::generation).
+    size_t append(const Packet& packet, uint64_t* generation = nullptr) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        Directory* d = current.load();
+        size_t n = d->count.load(std::memory_order_relaxed);
+        size_t ci = n / kChunkSize;
+
+        if (n % kChunkSize == 0) {
+            if (ci == d->capacity) d = grow(d);
+            d->slots[ci].store(new Chunk(), std::memory_order_release);
+        }
+
+        Chunk& c = *d->slots[ci].load(std::memory_order_relaxed);
+        int64_t ts = toUsec(packet.timestamp);
+        if (c.filled == 0) {
+            c.minTs.store(ts, std::memory_order_relaxed);
+            c.maxTs.store(ts, std::memory_order_relaxed);
+            c.minId.store(packet.id, std::memory_order_relaxed);
+            c.maxId.store(packet.id, std::memory_order_relaxed);
+        } else {
+            c.minTs.store(std::min(c.minTs.load(std::memory_order_relaxed), ts), std::memory_order_relaxed);
+            c.maxTs.store(std::max(c.maxTs.load(std::memory_order_relaxed), ts), std::memory_order_relaxed);
+            c.minId.store(std::min(c.minId.load(std::memory_order_relaxed), packet.id), std::memory_order_relaxed);
+            c.maxId.store(std::max(c.maxId.load(std::memory_order_relaxed), packet.id), std::memory_order_relaxed);
+        }
+        new (&c.entries[c.filled]) Packet(packet);
+        Columns& col = *c.columns;
+        col.tsUsec[c.filled] = ts;
+        col.srcKey[c.filled] = packet.srcKey;
+        col.dstKey[c.filled] = packet.dstKey;
+        col.srcPort[c.filled] = packet.srcPort;
+        col.dstPort[c.filled] = packet.dstPort;
+        col.size[c.filled] = static_cast<uint32_t>(packet.size);
+        col.protocol[c.filled] = packet.ipProtocol;
+        c.filled++;
+
+        d->count.store(n + 1, std::memory_order_release);
+        if (epochs.hasPending()) epochs.reclaim();
+        if (generation) *generation = d->generation;
+        return n;
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    int size() const {
+        return static_cast<int>(current.load()->count.load(std::memory_order_acquire));
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(writeLock);
+        Directory* old = current.load();
+        current.store(new Directory(64, old->generation + 1));
+        old->ownsChunks = true;
+        epochs.retire(old);
+    }
+
+    // Drops full chunks from the front, oldest first, for as long as at
+    // least `keep` packets remain. Only for packets that are kept
+    // elsewhere (the disk store): they are gone from here for good.
+    // Returns the number of packets evicted.
+    size_t evictOldest(size_t keep) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        Directory* d = current.load();
+        size_t n = d->count.load(std::memory_order_relaxed);
+        size_t first = d->first.load(std::memory_order_relaxed);
+        size_t evicted = 0;
+        while (n - first >= keep + kChunkSize) {
+            Chunk* c = d->slots[first / kChunkSize].load(std::memory_order_relaxed);
+            if (first == 0) {
+                d->evictedMinTs.store(c->minTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                d->evictedMinId.store(c->minId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            }
+            d->evictedMaxTs.store(c->maxTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            d->evictedMaxId.store(c->maxId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            first += kChunkSize;
+            evicted += kChunkSize;
+            // Snapshots that still index below `first` pinned their epoch
+            // before this, so the chunk outlives them.
+            d->first.store(first, std::memory_order_release);
+            epochs.retire(c);
+        }
+        return evicted;
+    }
+
+    // Swaps a full chunk for a compacted copy of its packets, built by the
+    // caller from a Snapshot of the given generation. Returns false (and
+    // changes nothing) if the store was cleared or the chunk was already
+    // replaced in the meantime.
+    bool replaceChunk(size_t chunkIndex, uint64_t generation, const std::vector<Packet>& packets) {
+        if (packets.size() != kChunkSize) return false;
+
+        Chunk* c = new Chunk();
+        for (size_t i = 0; i < packets.size(); i++) new (&c->entries[i]) Packet(packets[i]);
+        c->filled = packets.size();
+        c->compacted = true;
+
+        std::lock_guard<std::mutex> lock(writeLock);
+        Directory* d = current.load();
+        Chunk* old = chunkIndex < d->capacity ? d->slots[chunkIndex].load(std::memory_order_relaxed) : nullptr;
+        if (d->generation != generation || chunkIndex < d->first.load(std::memory_order_relaxed) / kChunkSize ||
+            !old || old->compacted || old->filled != kChunkSize) {
+            delete c;
+            return false;
+        }
+        c->minTs.store(old->minTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c->maxTs.store(old->maxTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c->minId.store(old->minId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        c->maxId.store(old->maxId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        *c->columns = *old->columns;
+        d->slots[chunkIndex].store(c, std::memory_order_release);
+        epochs.retire(old);
+        return true;
+    }
+
+    static int64_t toUsec(const timeval& tv) {
+        return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+    }
+
+private:
+    // Publishes a directory with twice the slots; chunks are shared with
+    // the old directory, which is retired without freeing them.
+    Directory* grow(Directory* old) {
+        Directory* d = new Directory(old->capacity * 2, old->generation);
+        for (size_t i = 0; i < old->capacity; i++) {
+            d->slots[i].store(old->slots[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        d->count.store(old->count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->first.store(old->first.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->evictedMinTs.store(old->evictedMinTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->evictedMaxTs.store(old->evictedMaxTs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->evictedMinId.store(old->evictedMinId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->evictedMaxId.store(old->evictedMaxId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        current.store(d);
+        epochs.retire(old);
+        return d;
+    }
+
+    PacketStore(const PacketStore&);
+    PacketStore& operator=(const PacketStore&);
+};
+
+#endif
\ No newline at end of file
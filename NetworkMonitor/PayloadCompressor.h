@@ -0,0 +1,210 @@
+#ifndef PAYLOAD_COMPRESSOR_H
+#define PAYLOAD_COMPRESSOR_H
+
+#include "Packet.h"
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Payload bytes of a run of packets, concatenated and compressed as one
+// block. offsets[i]..offsets[i+1] is the i-th packet's slice of the
+// uncompressed data.
+struct PayloadBlock {
+    std::vector<unsigned char> bytes;
+    std::vector<uint32_t> offsets;
+    uint32_t rawSize;
+    bool stored;                // kept uncompressed (data did not shrink)
+};
+
+// Moves packet payloads into compressed blocks and restores them on
+// demand. Everything up to the end of the L4 header stays in Packet::data
+// (so dissection and filtering never need the payload); the rest lives in
+// a shared PayloadBlock until a caller needs the original bytes.
+//
+// The codec is a small LZ77 byte-oriented format in the spirit of LZ4:
+// sequences of [token][literal length][literals][offset][match length],
+// with a 4-byte hash of recent positions to find matches.
+class PayloadCompressor {
+public:
+    enum { kPacketsPerBlock = 64 };
+
+    // Restores full frames, caching the last decompressed block so that
+    // replaying consecutive packets decompresses each block only once.
+    class Inflater {
+    public:
+        void inflate(Packet& p) {
+            if (!p.payloadBlock) return;
+            if (p.payloadBlock != cachedBlock) {
+                cachedBlock = p.payloadBlock;
+                if (!decodeBlock(*cachedBlock, raw)) {
+                    cachedBlock.reset();
+                    return;
+                }
+            }
+            uint32_t begin = cachedBlock->offsets[p.blockSlot];
+            uint32_t end = cachedBlock->offsets[p.blockSlot + 1];
+            p.data.insert(p.data.end(), raw.begin() + begin, raw.begin() + end);
+            p.payloadBlock.reset();
+            p.blockSlot = 0;
+        }
+
+    private:
+        std::shared_ptr<const PayloadBlock> cachedBlock;
+        std::vector<unsigned char> raw;
+    };
+
+    // Compresses the payloads of packets[first, last) into one block and
+    // truncates their data to the headers. Returns the block's size.
+    static size_t compressRange(std::vector<Packet>& packets, size_t first, size_t last) {
+        std::shared_ptr<PayloadBlock> block = std::make_shared<PayloadBlock>();
+        std::vector<unsigned char> raw;
+
+        block->offsets.push_back(0);
+        for (size_t i = first; i < last; i++) {
+            const Packet& p = packets[i];
+            size_t keep = headerLength(p);
+            if (!p.payloadBlock && p.data.size() > keep) {
+                raw.insert(raw.end(), p.data.begin() + keep, p.data.end());
+            }
+            block->offsets.push_back(static_cast<uint32_t>(raw.size()));
+        }
+        if (raw.empty()) return 0;
+
+        block->rawSize = static_cast<uint32_t>(raw.size());
+        compress(raw.data(), raw.size(), block->bytes);
+        block->stored = block->bytes.size() >= raw.size();
+        if (block->stored) block->bytes.swap(raw);
+        block->bytes.shrink_to_fit();
+
+        std::shared_ptr<const PayloadBlock> shared = block;
+        for (size_t i = first; i < last; i++) {
+            Packet& p = packets[i];
+            if (p.payloadBlock || block->offsets[i - first] == block->offsets[i - first + 1]) continue;
+            std::vector<unsigned char> head(p.data.begin(), p.data.begin() + headerLength(p));
+            p.data.swap(head);
+            p.payloadBlock = shared;
+            p.blockSlot = static_cast<uint32_t>(i - first);
+        }
+        return block->bytes.size();
+    }
+
+    static size_t headerLength(const Packet& p) {
+        if (p.payloadOffset > 0 && p.payloadOffset <= p.data.size()) return p.payloadOffset;
+        return std::min<size_t>(p.data.size(), 14);
+    }
+
+    static void compress(const unsigned char* src, size_t n, std::vector<unsigned char>& out) {
+        out.clear();
+        out.reserve(n + n / 255 + 16);
+
+        enum { kHashBits = 12, kMinMatch = 4, kTail = 12 };
+        uint32_t table[1 << kHashBits];
+        memset(table, 0, sizeof(table));
+
+        size_t anchor = 0;
+        size_t i = 0;
+        size_t limit = n > kTail ? n - kTail : 0;
+
+        while (i < limit) {
+            uint32_t seq = read32(src + i);
+            uint32_t h = (seq * 2654435761u) >> (32 - kHashBits);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(i + 1);
+
+            if (ref == 0 || i - (ref - 1) > 0xFFFF || read32(src + ref - 1) != seq) {
+                i += 1 + ((i - anchor) >> 6);      // skip faster through incompressible data
+                continue;
+            }
+            ref--;
+
+            size_t len = kMinMatch;
+            while (i + len < n - 5 && src[ref + len] == src[i + len]) len++;
+
+            emitSequence(out, src + anchor, i - anchor, static_cast<uint32_t>(i - ref), len - kMinMatch);
+            i += len;
+            anchor = i;
+        }
+
+        // Trailing literals, with no match part.
+        size_t lit = n - anchor;
+        out.push_back(static_cast<unsigned char>((lit >= 15 ? 15 : lit) << 4));
+        if (lit >= 15) writeLength(out, lit - 15);
+        out.insert(out.end(), src + anchor, src + n);
+    }
+
+    static bool decompress(const unsigned char* src, size_t n, unsigned char* dst, size_t rawSize) {
+        const unsigned char* end = src + n;
+        size_t out = 0;
+
+        while (src < end) {
+            unsigned token = *src++;
+            size_t lit = token >> 4;
+            if (lit == 15 && !readLength(src, end, lit)) return false;
+            if (lit > static_cast<size_t>(end - src) || out + lit > rawSize) return false;
+            if (lit) memcpy(dst + out, src, lit);
+            src += lit;
+            out += lit;
+            if (src == end) break;
+
+            if (end - src < 2) return false;
+            size_t offset = src[0] | (src[1] << 8);
+            src += 2;
+            size_t len = token & 15;
+            if (len == 15 && !readLength(src, end, len)) return false;
+            len += 4;
+            if (offset == 0 || offset > out || out + len > rawSize) return false;
+            for (size_t k = 0; k < len; k++, out++) dst[out] = dst[out - offset];
+        }
+        return out == rawSize;
+    }
+
+private:
+    static bool decodeBlock(const PayloadBlock& block, std::vector<unsigned char>& raw) {
+        if (block.stored) {
+            raw = block.bytes;
+            return true;
+        }
+        raw.resize(block.rawSize);
+        return decompress(block.bytes.data(), block.bytes.size(), raw.data(), raw.size());
+    }
+
+    static uint32_t read32(const unsigned char* p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    static void writeLength(std::vector<unsigned char>& out, size_t len) {
+        while (len >= 255) {
+            out.push_back(255);
+            len -= 255;
+        }
+        out.push_back(static_cast<unsigned char>(len));
+    }
+
+    static bool readLength(const unsigned char*& src, const unsigned char* end, size_t& len) {
+        unsigned char b;
+        do {
+            if (src == end) return false;
+            b = *src++;
+            len += b;
+        } while (b == 255);
+        return true;
+    }
+
+    static void emitSequence(std::vector<unsigned char>& out, const unsigned char* lit, size_t litLen,
+                             uint32_t offset, size_t matchExtra) {
+        unsigned char token = static_cast<unsigned char>(((litLen >= 15 ? 15 : litLen) << 4) |
+                                                         (matchExtra >= 15 ? 15 : matchExtra));
+        out.push_back(token);
+        if (litLen >= 15) writeLength(out, litLen - 15);
+        out.insert(out.end(), lit, lit + litLen);
+        out.push_back(static_cast<unsigned char>(offset & 0xFF));
+        out.push_back(static_cast<unsigned char>(offset >> 8));
+        if (matchExtra >= 15) writeLength(out, matchExtra - 15);
+    }
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,576 @@
+#ifndef SEGMENT_STORE_H
+#define SEGMENT_STORE_H
+
+#include "Packet.h"
+#include "Epoch.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+// Append-only on-disk packet store. Packets are written into fixed-size
+// segment files that are mmap'd while active; once a segment fills up it
+// is sealed and a small sidecar index (time/ID range, sparse time index and
+// src/dst bloom filters) is written next to it. Queries consult only the
+// in-memory index summaries and map just the segments that can contain
+// matches, so the page cache does the rest.
+//
+// Queries may run on other threads while the capture thread appends. A
+// reader sees sealed segments through their (immutable) index and the
+// active segment up to its published length, and maps files on its own;
+// the segment list itself is republished on change and old copies are
+// reclaimed through an EpochManager, so readers never take a lock.
+class SegmentStore {
+public:
+    struct RecordHeader {
+        uint32_t length;        // whole record including header and padding
+        int32_t id;
+        int64_t tsUsec;
+        uint32_t size;
+        uint32_t ifIndex;       // ingress interface, 0 if unknown
+        char srcIP[46];
+        char dstIP[46];
+        char protocol[8];
+        uint32_t sampleWeight;  // 0 in segments written before sampling existed
+    };
+
+    struct RecordView {
+        const RecordHeader* header;
+        const unsigned char* data;
+    };
+
+private:
+    enum {
+        kIndexStride = 64,      // one sparse time index entry per N records
+        kBloomBytes = 1024,
+        kRecordAlign = 8
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint64_t recordCount;
+        uint64_t writeOffset;
+        uint64_t capacity;
+    };
+
+    struct IndexEntry {
+        int64_t tsUsec;
+        uint64_t offset;
+    };
+
+    struct Segment {
+        std::string dataPath;
+        std::string indexPath;
+        uint64_t recordCount;
+        uint64_t bytesUsed;
+        int64_t minTs;
+        int64_t maxTs;
+        int32_t minId;
+        int32_t maxId;
+        unsigned char srcBloom[kBloomBytes];
+        unsigned char dstBloom[kBloomBytes];
+        std::vector<IndexEntry> sparse;
+
+        // Reader-visible state. Index fields above are only trusted once
+        // `sealed` is set; before that readers scan up to publishedBytes.
+        std::atomic<uint64_t> publishedBytes;
+        std::atomic<uint64_t> publishedRecords;
+        std::atomic<bool> sealed;
+
+        Segment() : recordCount(0), bytesUsed(sizeof(FileHeader)),
+                    minTs(0), maxTs(0), minId(0), maxId(0),
+                    publishedBytes(sizeof(FileHeader)), publishedRecords(0), sealed(false) {
+            memset(srcBloom, 0, sizeof(srcBloom));
+            memset(dstBloom, 0, sizeof(dstBloom));
+        }
+    };
+
+    struct SegmentList {
+        std::vector<Segment*> items;
+    };
+
+    std::string directory;                  // kept after close()
+    std::atomic<bool> opened;               // read from any thread
+    size_t segmentCapacity;
+    std::vector<Segment*> segments;         // writer side
+    unsigned nextSegmentNumber;
+
+    int activeFd;
+    unsigned char* activeMap;
+
+    std::atomic<SegmentList*> published;    // reader side
+    mutable EpochManager epochs;
+
+public:
+    SegmentStore() : opened(false), segmentCapacity(0), nextSegmentNumber(0),
+                     activeFd(-1), activeMap(nullptr), published(new SegmentList()) {}
+
+    ~SegmentStore() {
+        close();
+        delete published.load();
+    }
+
+    bool isOpen() const {
+        return opened.load(std::memory_order_acquire);
+    }
+
+    const std::string& getDirectory() const {
+        return directory;
+    }
+
+    // Opens (or creates) a store directory. Existing segments are indexed
+    // from their sidecar files; segments without one (e.g. after a crash)
+    // are rescanned and sealed. New packets always go to a fresh segment.
+    // open() and close() must not race with append().
+    void open(const std::string& dir, size_t capacityBytes) {
+        close();
+        if (capacityBytes < 1024 * 1024) capacityBytes = 1024 * 1024;
+
+        if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+            throw std::runtime_error("Cannot create store directory " + dir + ": " + strerror(errno));
+        }
+
+        DIR* d = opendir(dir.c_str());
+        if (!d) {
+            throw std::runtime_error("Cannot open store directory " + dir + ": " + strerror(errno));
+        }
+
+        std::vector<unsigned> numbers;
+        while (struct dirent* entry = readdir(d)) {
+            unsigned number;
+            char suffix[8];
+            if (sscanf(entry->d_name, "segment-%u.%7s", &number, suffix) == 2 &&
+                strcmp(suffix, "dat") == 0) {
+                numbers.push_back(number);
+            }
+        }
+        closedir(d);
+        std::sort(numbers.begin(), numbers.end());
+
+        directory = dir;
+        segmentCapacity = capacityBytes;
+        nextSegmentNumber = 0;
+
+        for (size_t i = 0; i < numbers.size(); i++) {
+            Segment* seg = new Segment();
+            seg->dataPath = segmentPath(numbers[i], "dat");
+            seg->indexPath = segmentPath(numbers[i], "idx");
+            if (!loadIndex(*seg)) {
+                rebuildIndex(*seg);
+                writeIndex(*seg);
+            }
+            publishSealed(*seg);
+            segments.push_back(seg);
+            nextSegmentNumber = numbers[i] + 1;
+        }
+        publishList();
+        opened.store(true, std::memory_order_release);
+    }
+
+    void close() {
+        if (activeMap) sealActive();
+        std::vector<Segment*> old;
+        old.swap(segments);
+        publishList();
+        for (size_t i = 0; i < old.size(); i++) epochs.retire(old[i]);
+        opened.store(false, std::memory_order_release);
+    }
+
+    void append(const Packet& packet) {
+        if (!isOpen()) return;
+
+        uint64_t length = alignUp(sizeof(RecordHeader) + packet.size);
+        if (activeMap && segments.back()->bytesUsed + length > segmentCapacity) {
+            sealActive();
+        }
+        if (!activeMap) startSegment();
+
+        Segment& seg = *segments.back();
+        if (seg.bytesUsed + length > segmentCapacity) return;   // frame larger than a segment
+
+        RecordHeader* rec = reinterpret_cast<RecordHeader*>(activeMap + seg.bytesUsed);
+        memset(rec, 0, sizeof(RecordHeader));
+        rec->length = static_cast<uint32_t>(length);
+        rec->id = packet.id;
+        rec->tsUsec = toUsec(packet.timestamp);
+        rec->size = static_cast<uint32_t>(packet.size);
+        rec->ifIndex = static_cast<uint32_t>(packet.ifIndex);
+        rec->sampleWeight = packet.sampleWeight;
+        strncpy(rec->srcIP, packet.srcIP.c_str(), sizeof(rec->srcIP) - 1);
+        strncpy(rec->dstIP, packet.dstIP.c_str(), sizeof(rec->dstIP) - 1);
+        strncpy(rec->protocol, packet.protocol.c_str(), sizeof(rec->protocol) - 1);
+        if (packet.size > 0) {
+            memcpy(reinterpret_cast<unsigned char*>(rec) + sizeof(RecordHeader),
+                   packet.data.data(), packet.size);
+        }
+
+        indexRecord(seg, *rec, seg.bytesUsed);
+        seg.bytesUsed += length;
+
+        FileHeader* fh = reinterpret_cast<FileHeader*>(activeMap);
+        fh->writeOffset = seg.bytesUsed;
+        fh->recordCount = seg.recordCount;
+
+        seg.publishedRecords.store(seg.recordCount, std::memory_order_relaxed);
+        seg.publishedBytes.store(seg.bytesUsed, std::memory_order_release);
+    }
+
+    size_t segmentCount() const {
+        EpochManager::Guard guard(epochs);
+        return published.load()->items.size();
+    }
+
+    uint64_t recordCount() const {
+        EpochManager::Guard guard(epochs);
+        const std::vector<Segment*>& list = published.load()->items;
+        uint64_t total = 0;
+        for (size_t i = 0; i < list.size(); i++) total += list[i]->publishedRecords.load();
+        return total;
+    }
+
+    uint64_t bytesOnDisk() const {
+        EpochManager::Guard guard(epochs);
+        const std::vector<Segment*>& list = published.load()->items;
+        uint64_t total = 0;
+        for (size_t i = 0; i < list.size(); i++) total += list[i]->publishedBytes.load();
+        return total;
+    }
+
+    // Visits every record with fromUsec <= timestamp <= toUsec, in capture
+    // order. The visitor returns false to stop early. Returns the number of
+    // segments that had to be mapped.
+    template <typename Visitor>
+    size_t scanTimeRange(int64_t fromUsec, int64_t toUsec, Visitor visit) const {
+        EpochManager::Guard guard(epochs);
+        const std::vector<Segment*>& list = published.load()->items;
+        size_t mapped = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            const Segment& seg = *list[i];
+            bool sealed = seg.sealed.load(std::memory_order_acquire);
+            uint64_t end = seg.publishedBytes.load(std::memory_order_acquire);
+            if (end <= sizeof(FileHeader)) continue;
+
+            uint64_t start = sizeof(FileHeader);
+            if (sealed) {
+                if (seg.maxTs < fromUsec || seg.minTs > toUsec) continue;
+                for (size_t e = 0; e < seg.sparse.size() && seg.sparse[e].tsUsec < fromUsec; e++) {
+                    start = seg.sparse[e].offset;
+                }
+            }
+
+            MappedSegment view(seg, end, MADV_WILLNEED);
+            if (!view.base) continue;
+            mapped++;
+
+            for (uint64_t off = start; off < end; ) {
+                const RecordHeader* rec = reinterpret_cast<const RecordHeader*>(view.base + off);
+                if (rec->length == 0) break;
+                if (rec->tsUsec > toUsec) break;
+                if (rec->tsUsec >= fromUsec && !visit(makeView(rec))) return mapped;
+                off += rec->length;
+            }
+        }
+        return mapped;
+    }
+
+    // Visits every record whose source and destination match exactly.
+    // Segments whose bloom filters rule out either address are skipped
+    // without being mapped.
+    template <typename Visitor>
+    size_t scanAddressPair(const std::string& src, const std::string& dst, Visitor visit) const {
+        EpochManager::Guard guard(epochs);
+        const std::vector<Segment*>& list = published.load()->items;
+        size_t mapped = 0;
+        for (size_t i = 0; i < list.size(); i++) {
+            const Segment& seg = *list[i];
+            bool sealed = seg.sealed.load(std::memory_order_acquire);
+            uint64_t end = seg.publishedBytes.load(std::memory_order_acquire);
+            if (end <= sizeof(FileHeader)) continue;
+            if (sealed && (!bloomTest(seg.srcBloom, src) || !bloomTest(seg.dstBloom, dst))) continue;
+
+            MappedSegment view(seg, end, MADV_SEQUENTIAL);
+            if (!view.base) continue;
+            mapped++;
+
+            for (uint64_t off = sizeof(FileHeader); off < end; ) {
+                const RecordHeader* rec = reinterpret_cast<const RecordHeader*>(view.base + off);
+                if (rec->length == 0) break;
+                if (src == rec->srcIP && dst == rec->dstIP && !visit(makeView(rec))) return mapped;
+                off += rec->length;
+            }
+        }
+        return mapped;
+    }
+
+    static Packet toPacket(const RecordView& view) {
+        Packet p(view.header->id, view.data, view.header->size);
+        p.timestamp.tv_sec = static_cast<time_t>(view.header->tsUsec / 1000000);
+        p.timestamp.tv_usec = static_cast<suseconds_t>(view.header->tsUsec % 1000000);
+        p.srcIP = view.header->srcIP;
+        p.dstIP = view.header->dstIP;
+        p.protocol = view.header->protocol;
+        p.ifIndex = static_cast<int>(view.header->ifIndex);
+        p.sampleWeight = view.header->sampleWeight ? view.header->sampleWeight : 1;
+        return p;
+    }
+
+    static int64_t toUsec(const timeval& tv) {
+        return static_cast<int64_t>(tv.tv_sec) * 1000000 + tv.tv_usec;
+    }
+
+private:
+    // Read-only mapping of the published part of a segment for the
+    // duration of one query. It is independent of the writer's mapping,
+    // so the active segment may be sealed while a reader is scanning it.
+    struct MappedSegment {
+        const unsigned char* base;
+        size_t length;
+
+        MappedSegment(const Segment& seg, uint64_t end, int advice)
+            : base(nullptr), length(static_cast<size_t>(end)) {
+            int fd = ::open(seg.dataPath.c_str(), O_RDONLY);
+            if (fd < 0) return;
+            void* m = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd);
+            if (m == MAP_FAILED) return;
+            madvise(m, length, advice);
+            base = static_cast<const unsigned char*>(m);
+        }
+
+        ~MappedSegment() {
+            if (base) munmap(const_cast<unsigned char*>(base), length);
+        }
+
+    private:
+        MappedSegment(const MappedSegment&);
+        MappedSegment& operator=(const MappedSegment&);
+    };
+
+    static RecordView makeView(const RecordHeader* rec) {
+        RecordView v;
+        v.header = rec;
+        v.data = reinterpret_cast<const unsigned char*>(rec) + sizeof(RecordHeader);
+        return v;
+    }
+
+    static uint64_t alignUp(uint64_t n) {
+        return (n + kRecordAlign - 1) & ~static_cast<uint64_t>(kRecordAlign - 1);
+    }
+
+    static uint64_t hashString(const char* s) {
+        uint64_t h = 1469598103934665603ULL;
+        while (*s) {
+            h ^= static_cast<unsigned char>(*s++);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    static void bloomAdd(unsigned char* bloom, const char* s) {
+        uint64_t h = hashString(s);
+        uint32_t a = static_cast<uint32_t>(h) % (kBloomBytes * 8);
+        uint32_t b = static_cast<uint32_t>(h >> 32) % (kBloomBytes * 8);
+        bloom[a / 8] |= static_cast<unsigned char>(1u << (a % 8));
+        bloom[b / 8] |= static_cast<unsigned char>(1u << (b % 8));
+    }
+
+    static bool bloomTest(const unsigned char* bloom, const std::string& s) {
+        uint64_t h = hashString(s.c_str());
+        uint32_t a = static_cast<uint32_t>(h) % (kBloomBytes * 8);
+        uint32_t b = static_cast<uint32_t>(h >> 32) % (kBloomBytes * 8);
+        return (bloom[a / 8] & (1u << (a % 8))) && (bloom[b / 8] & (1u << (b % 8)));
+    }
+
+    static void indexRecord(Segment& seg, const RecordHeader& rec, uint64_t offset) {
+        if (seg.recordCount == 0) {
+            seg.minTs = seg.maxTs = rec.tsUsec;
+            seg.minId = seg.maxId = rec.id;
+        } else {
+            seg.minTs = std::min(seg.minTs, rec.tsUsec);
+            seg.maxTs = std::max(seg.maxTs, rec.tsUsec);
+            seg.minId = std::min(seg.minId, rec.id);
+            seg.maxId = std::max(seg.maxId, rec.id);
+        }
+        if (seg.recordCount % kIndexStride == 0) {
+            IndexEntry e;
+            e.tsUsec = rec.tsUsec;
+            e.offset = offset;
+            seg.sparse.push_back(e);
+        }
+        bloomAdd(seg.srcBloom, rec.srcIP);
+        bloomAdd(seg.dstBloom, rec.dstIP);
+        seg.recordCount++;
+    }
+
+    static void publishSealed(Segment& seg) {
+        seg.publishedRecords.store(seg.recordCount, std::memory_order_relaxed);
+        seg.publishedBytes.store(seg.bytesUsed, std::memory_order_relaxed);
+        seg.sealed.store(true, std::memory_order_release);
+    }
+
+    void publishList() {
+        SegmentList* next = new SegmentList();
+        next->items = segments;
+        SegmentList* old = published.exchange(next);
+        epochs.retire(old);
+    }
+
+    std::string segmentPath(unsigned number, const char* ext) const {
+        char name[64];
+        snprintf(name, sizeof(name), "/segment-%06u.%s", number, ext);
+        return directory + name;
+    }
+
+    void startSegment() {
+        Segment* seg = new Segment();
+        seg->dataPath = segmentPath(nextSegmentNumber, "dat");
+        seg->indexPath = segmentPath(nextSegmentNumber, "idx");
+        nextSegmentNumber++;
+
+        activeFd = ::open(seg->dataPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (activeFd < 0) {
+            delete seg;
+            throw std::runtime_error("Cannot create segment file: " + std::string(strerror(errno)));
+        }
+        // Reserve the blocks up front: a sparse file would only find out
+        // the disk is full when a store through the mapping faults (SIGBUS).
+        int err = posix_fallocate(activeFd, 0, static_cast<off_t>(segmentCapacity));
+        if (err != 0) {
+            ::close(activeFd);
+            activeFd = -1;
+            unlink(seg->dataPath.c_str());
+            delete seg;
+            throw std::runtime_error("Cannot reserve segment file: " + std::string(strerror(err)));
+        }
+        void* m = mmap(nullptr, segmentCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, activeFd, 0);
+        if (m == MAP_FAILED) {
+            ::close(activeFd);
+            activeFd = -1;
+            unlink(seg->dataPath.c_str());
+            delete seg;
+            throw std::runtime_error("Cannot map segment file: " + std::string(strerror(errno)));
+        }
+        activeMap = static_cast<unsigned char*>(m);
+
+        FileHeader* fh = reinterpret_cast<FileHeader*>(activeMap);
+        memcpy(fh->magic, "NMSEG01", 8);
+        fh->recordCount = 0;
+        fh->writeOffset = sizeof(FileHeader);
+        fh->capacity = segmentCapacity;
+
+        segments.push_back(seg);
+        publishList();
+    }
+
+    // Flushes the active segment, trims the file to the bytes actually
+    // used and writes its sidecar index.
+    void sealActive() {
+        Segment& seg = *segments.back();
+        msync(activeMap, segmentCapacity, MS_ASYNC);
+        munmap(activeMap, segmentCapacity);
+        activeMap = nullptr;
+        if (ftruncate(activeFd, static_cast<off_t>(seg.bytesUsed)) < 0) {
+            perror("Segment truncate failed");
+        }
+        ::close(activeFd);
+        activeFd = -1;
+        writeIndex(seg);
+        publishSealed(seg);
+    }
+
+    void writeIndex(const Segment& seg) const {
+        FILE* f = fopen(seg.indexPath.c_str(), "wb");
+        if (!f) {
+            perror("Segment index write failed");
+            return;
+        }
+        uint64_t sparseCount = seg.sparse.size();
+        fwrite("NMIDX01", 1, 8, f);
+        fwrite(&seg.recordCount, sizeof(seg.recordCount), 1, f);
+        fwrite(&seg.bytesUsed, sizeof(seg.bytesUsed), 1, f);
+        fwrite(&seg.minTs, sizeof(seg.minTs), 1, f);
+        fwrite(&seg.maxTs, sizeof(seg.maxTs), 1, f);
+        fwrite(&seg.minId, sizeof(seg.minId), 1, f);
+        fwrite(&seg.maxId, sizeof(seg.maxId), 1, f);
+        fwrite(seg.srcBloom, 1, sizeof(seg.srcBloom), f);
+        fwrite(seg.dstBloom, 1, sizeof(seg.dstBloom), f);
+        fwrite(&sparseCount, sizeof(sparseCount), 1, f);
+        if (sparseCount) fwrite(seg.sparse.data(), sizeof(IndexEntry), seg.sparse.size(), f);
+        fclose(f);
+    }
+
+    bool loadIndex(Segment& seg) const {
+        FILE* f = fopen(seg.indexPath.c_str(), "rb");
+        if (!f) return false;
+
+        char magic[8];
+        uint64_t sparseCount = 0;
+        bool ok = fread(magic, 1, 8, f) == 8 && memcmp(magic, "NMIDX01", 8) == 0 &&
+                  fread(&seg.recordCount, sizeof(seg.recordCount), 1, f) == 1 &&
+                  fread(&seg.bytesUsed, sizeof(seg.bytesUsed), 1, f) == 1 &&
+                  fread(&seg.minTs, sizeof(seg.minTs), 1, f) == 1 &&
+                  fread(&seg.maxTs, sizeof(seg.maxTs), 1, f) == 1 &&
+                  fread(&seg.minId, sizeof(seg.minId), 1, f) == 1 &&
+                  fread(&seg.maxId, sizeof(seg.maxId), 1, f) == 1 &&
+                  fread(seg.srcBloom, 1, sizeof(seg.srcBloom), f) == sizeof(seg.srcBloom) &&
+                  fread(seg.dstBloom, 1, sizeof(seg.dstBloom), f) == sizeof(seg.dstBloom) &&
+                  fread(&sparseCount, sizeof(sparseCount), 1, f) == 1;
+        if (ok) {
+            seg.sparse.resize(static_cast<size_t>(sparseCount));
+            ok = sparseCount == 0 ||
+                 fread(seg.sparse.data(), sizeof(IndexEntry), seg.sparse.size(), f) == seg.sparse.size();
+        }
+        fclose(f);
+        return ok;
+    }
+
+    void rebuildIndex(Segment& seg) const {
+        int fd = ::open(seg.dataPath.c_str(), O_RDWR);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            return;
+        }
+        size_t length = static_cast<size_t>(st.st_size);
+        void* m = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED) {
+            ::close(fd);
+            return;
+        }
+
+        const unsigned char* base = static_cast<const unsigned char*>(m);
+        const FileHeader* fh = reinterpret_cast<const FileHeader*>(base);
+        uint64_t end = std::min<uint64_t>(fh->writeOffset, length);
+        uint64_t off = sizeof(FileHeader);
+        while (off + sizeof(RecordHeader) <= end) {
+            const RecordHeader* rec = reinterpret_cast<const RecordHeader*>(base + off);
+            if (rec->length < sizeof(RecordHeader) || off + rec->length > end) break;
+            indexRecord(seg, *rec, off);
+            off += rec->length;
+        }
+        seg.bytesUsed = off;
+        munmap(m, length);
+
+        if (ftruncate(fd, static_cast<off_t>(seg.bytesUsed)) < 0) {
+            perror("Segment truncate failed");
+        }
+        ::close(fd);
+    }
+
+    SegmentStore(const SegmentStore&);
+    SegmentStore& operator=(const SegmentStore&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,298 @@
+#ifndef SIGNATURE_SCANNER_H
+#define SIGNATURE_SCANNER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIGNATURE_SCANNER_SSSE3 1
+#include <tmmintrin.h>
+#endif
+
+// Finds every occurrence of a set of byte signatures in one pass over a
+// buffer. The signatures are compiled into an Aho-Corasick automaton and
+// then into a full DFA (one table lookup per input byte, no failure-link
+// chasing), over a compressed alphabet: bytes that occur in no signature
+// share a single column, so the table stays small for thousands of
+// signatures.
+//
+// While the automaton sits in its start state, any byte that begins no
+// signature leaves it there, so the scan skips ahead to the next possible
+// first byte, 16 input bytes per step. On CPUs with SSSE3 (checked at run
+// time) the set of first bytes is a nibble bitmap looked up with PSHUFB,
+// which costs the same for any number of first bytes; otherwise SSE2
+// compares against each first byte, for up to 16 of them.
+//
+// A compiled scanner is immutable and may be shared between threads.
+class SignatureScanner {
+public:
+    enum { kMatchFlag = 0x80000000u };
+
+private:
+    std::vector<std::string> patterns;
+    std::vector<std::string> names;
+
+    unsigned char byteClass[256];
+    uint32_t classCount;
+    // delta[row + class]: next state's row (state * classCount), with
+    // kMatchFlag set if a signature ends in that state.
+    std::vector<uint32_t> delta;
+    std::vector<std::vector<uint32_t> > outputs;     // per state, incl. suffixes
+
+    bool startByte[256];
+    std::vector<unsigned char> startBytes;
+#ifdef __SSE2__
+    __m128i needles[16];
+#endif
+    // startByte as two 16-byte tables indexed by the low nibble: bit
+    // (b >> 4) of lowTable[b & 15] for b < 0x80, bit (b >> 4) - 8 of
+    // highTable[b & 15] for the rest.
+    unsigned char lowTable[16];
+    unsigned char highTable[16];
+    bool nibbleSkip;
+    bool compiled;
+
+public:
+    SignatureScanner() : classCount(1), nibbleSkip(false), compiled(false) {
+        memset(byteClass, 0, sizeof(byteClass));
+        memset(startByte, 0, sizeof(startByte));
+    }
+
+    // Empty patterns are ignored. Must be called before compile().
+    void addPattern(const std::string& bytes, const std::string& name) {
+        if (bytes.empty() || compiled) return;
+        patterns.push_back(bytes);
+        names.push_back(name);
+    }
+
+    size_t patternCount() const {
+        return patterns.size();
+    }
+
+    size_t stateCount() const {
+        return outputs.size();
+    }
+
+    uint32_t alphabetSize() const {
+        return classCount;
+    }
+
+    const std::string& patternName(uint32_t id) const {
+        return names[id];
+    }
+
+    void compile() {
+        // Alphabet compression: one class per byte used by any signature.
+        classCount = 1;
+        memset(byteClass, 0, sizeof(byteClass));
+        for (size_t p = 0; p < patterns.size(); p++) {
+            for (size_t i = 0; i < patterns[p].size(); i++) {
+                unsigned char b = static_cast<unsigned char>(patterns[p][i]);
+                if (!byteClass[b]) byteClass[b] = static_cast<unsigned char>(classCount++);
+            }
+        }
+        // More than 255 used bytes cannot be numbered in a byte; fall back
+        // to the identity alphabet.
+        if (classCount > 256) {
+            for (int b = 0; b < 256; b++) byteClass[b] = static_cast<unsigned char>(b);
+            classCount = 256;
+        }
+
+        // Trie, with 0 = no edge (the root is never a child).
+        std::vector<uint32_t> go(classCount, 0);
+        outputs.assign(1, std::vector<uint32_t>());
+        for (size_t p = 0; p < patterns.size(); p++) {
+            uint32_t s = 0;
+            for (size_t i = 0; i < patterns[p].size(); i++) {
+                uint32_t c = byteClass[static_cast<unsigned char>(patterns[p][i])];
+                if (!go[s * classCount + c]) {
+                    go[s * classCount + c] = static_cast<uint32_t>(outputs.size());
+                    outputs.push_back(std::vector<uint32_t>());
+                    go.resize(outputs.size() * classCount, 0);
+                }
+                s = go[s * classCount + c];
+            }
+            outputs[s].push_back(static_cast<uint32_t>(p));
+        }
+
+        // Breadth-first: failure links, and the DFA row of each state from
+        // its trie edges plus its failure state's (already final) row.
+        size_t states = outputs.size();
+        std::vector<uint32_t> fail(states, 0);
+        std::vector<uint32_t> next(states * classCount, 0);
+        std::queue<uint32_t> order;
+        for (uint32_t c = 0; c < classCount; c++) {
+            uint32_t t = go[c];
+            next[c] = t;
+            if (t) order.push(t);
+        }
+        while (!order.empty()) {
+            uint32_t s = order.front();
+            order.pop();
+            const std::vector<uint32_t>& inherited = outputs[fail[s]];
+            outputs[s].insert(outputs[s].end(), inherited.begin(), inherited.end());
+            for (uint32_t c = 0; c < classCount; c++) {
+                uint32_t t = go[s * classCount + c];
+                if (t) {
+                    fail[t] = next[fail[s] * classCount + c];
+                    next[s * classCount + c] = t;
+                    order.push(t);
+                } else {
+                    next[s * classCount + c] = next[fail[s] * classCount + c];
+                }
+            }
+        }
+
+        delta.resize(next.size());
+        for (size_t i = 0; i < next.size(); i++) {
+            uint32_t t = next[i];
+            delta[i] = t * classCount | (outputs[t].empty() ? 0u : static_cast<uint32_t>(kMatchFlag));
+        }
+
+        memset(startByte, 0, sizeof(startByte));
+        startBytes.clear();
+        for (int b = 0; b < 256; b++) {
+            if (next[byteClass[b]] != 0) {
+                startByte[b] = true;
+                startBytes.push_back(static_cast<unsigned char>(b));
+            }
+        }
+#ifdef __SSE2__
+        for (size_t k = 0; k < startBytes.size() && k < 16; k++) {
+            needles[k] = _mm_set1_epi8(static_cast<char>(startBytes[k]));
+        }
+#endif
+        memset(lowTable, 0, sizeof(lowTable));
+        memset(highTable, 0, sizeof(highTable));
+        for (size_t k = 0; k < startBytes.size(); k++) {
+            unsigned char b = startBytes[k];
+            if (b < 0x80) lowTable[b & 15] |= static_cast<unsigned char>(1 << (b >> 4));
+            else highTable[b & 15] |= static_cast<unsigned char>(1 << ((b >> 4) - 8));
+        }
+#ifdef SIGNATURE_SCANNER_SSSE3
+        nibbleSkip = __builtin_cpu_supports("ssse3");
+#endif
+        compiled = true;
+    }
+
+    // Calls onMatch(signatureId, endOffset) for every occurrence of every
+    // signature in data[0, len). Returns the number of occurrences.
+    template <typename F>
+    size_t scan(const unsigned char* data, size_t len, F onMatch) const {
+        if (!compiled || patterns.empty()) return 0;
+        size_t found = 0;
+        uint32_t row = 0;
+        const uint32_t* table = delta.data();
+
+        for (size_t i = 0; i < len; i++) {
+            if (row == 0) {
+                i = skipToStart(data, i, len);
+                if (i == len) break;
+            }
+            uint32_t e = table[row + byteClass[data[i]]];
+            row = e & ~kMatchFlag;
+            if (e & kMatchFlag) {
+                const std::vector<uint32_t>& out = outputs[row / classCount];
+                for (size_t k = 0; k < out.size(); k++) onMatch(out[k], i + 1);
+                found += out.size();
+            }
+        }
+        return found;
+    }
+
+    // Signature file lines are byte strings with \xNN, \\, \r, \n and \t
+    // escapes; blank lines and lines starting with '#' are skipped. An
+    // optional "name: " prefix (up to the first ": ") names the signature.
+    static bool parseLine(const std::string& line, std::string& name, std::string& bytes) {
+        if (line.empty() || line[0] == '#') return false;
+        std::string body = line;
+        size_t colon = line.find(": ");
+        name.clear();
+        if (colon != std::string::npos && colon > 0) {
+            name = line.substr(0, colon);
+            body = line.substr(colon + 2);
+        }
+        bytes.clear();
+        for (size_t i = 0; i < body.size(); i++) {
+            char ch = body[i];
+            if (ch == '\r') continue;
+            if (ch != '\\' || i + 1 == body.size()) {
+                bytes += ch;
+                continue;
+            }
+            char e = body[++i];
+            if (e == 'x' && i + 2 < body.size() && isxdigit(static_cast<unsigned char>(body[i + 1])) &&
+                isxdigit(static_cast<unsigned char>(body[i + 2]))) {
+                bytes += static_cast<char>(std::stoi(body.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else if (e == 'r') {
+                bytes += '\r';
+            } else if (e == 'n') {
+                bytes += '\n';
+            } else if (e == 't') {
+                bytes += '\t';
+            } else {
+                bytes += e;
+            }
+        }
+        if (name.empty()) name = body;
+        return !bytes.empty();
+    }
+
+private:
+    // First index >= i holding a byte some signature starts with.
+    size_t skipToStart(const unsigned char* data, size_t i, size_t len) const {
+#ifdef SIGNATURE_SCANNER_SSSE3
+        if (nibbleSkip) return skipToStartNibbles(data, i, len);
+#endif
+#ifdef __SSE2__
+        size_t n = startBytes.size();
+        if (n <= 16) {
+            while (i + 16 <= len) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i hit = _mm_setzero_si128();
+                for (size_t k = 0; k < n; k++) hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, needles[k]));
+                int mask = _mm_movemask_epi8(hit);
+                if (mask) return i + __builtin_ctz(mask);
+                i += 16;
+            }
+        }
+#endif
+        while (i < len && !startByte[data[i]]) i++;
+        return i;
+    }
+
+#ifdef SIGNATURE_SCANNER_SSSE3
+    // PSHUFB returns 0 for index bytes with the top bit set, so looking up
+    // b in lowTable and b ^ 0x80 in highTable leaves exactly one of them
+    // non-zero; ANDing with 1 << ((b >> 4) & 7) picks the bit for b.
+    __attribute__((target("ssse3")))
+    size_t skipToStartNibbles(const unsigned char* data, size_t i, size_t len) const {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lowTable));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(highTable));
+        const __m128i bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+        const __m128i nibble = _mm_set1_epi8(0x0f);
+        const __m128i flip = _mm_set1_epi8(-128);
+        while (i + 16 <= len) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            __m128i row = _mm_or_si128(_mm_shuffle_epi8(low, block),
+                                       _mm_shuffle_epi8(high, _mm_xor_si128(block, flip)));
+            __m128i bit = _mm_shuffle_epi8(bits, _mm_and_si128(_mm_srli_epi16(block, 4), nibble));
+            __m128i miss = _mm_cmpeq_epi8(_mm_and_si128(row, bit), _mm_setzero_si128());
+            int mask = ~_mm_movemask_epi8(miss) & 0xffff;
+            if (mask) return i + __builtin_ctz(mask);
+            i += 16;
+        }
+        while (i < len && !startByte[data[i]]) i++;
+        return i;
+    }
+#endif
+};
+
+#endif
\ No newline at end of file
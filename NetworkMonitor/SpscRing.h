@@ -0,0 +1,56 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+// Bounded single-producer/single-consumer ring. One thread pushes, one
+// thread pops; neither ever blocks or takes a lock. A full ring rejects
+// the push, which is how callers detect that the consumer fell behind.
+template <typename T>
+class SpscRing {
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;       // next slot to pop
+    alignas(64) std::atomic<size_t> tail;       // next slot to push
+
+public:
+    explicit SpscRing(size_t capacity) : mask(0), head(0), tail(0) {
+        size_t n = 2;
+        while (n < capacity) n <<= 1;
+        slots.resize(n);
+        mask = n - 1;
+    }
+
+    bool tryPush(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) return false;
+        slots[t & mask] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    SpscRing(const SpscRing&);
+    SpscRing& operator=(const SpscRing&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,196 @@
+#ifndef STANDING_FILTER_H
+#define STANDING_FILTER_H
+
+#include "Packet.h"
+#include "Epoch.h"
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+// An IP filter registered ahead of capture and evaluated on every packet
+// as soon as it is dissected. Its matches pile up while traffic arrives,
+// so the filtered view is ready at any time without rescanning the whole
+// store. The oversized-packet policy of the batch filters (at most
+// `oversizedThreshold` packets over 1500 bytes) is applied as matches come
+// in rather than over the finished list.
+//
+// Matches are kept as an append-only list of PacketStore indexes and
+// packet IDs (not copies of the packets), published the same way as
+// PacketStore: blocks of entries behind a directory whose count is stored
+// with release ordering, grown by swapping in a new directory that is
+// reclaimed through an EpochManager. Readers take a Snapshot and no lock. The list
+// is tied to a store generation; once the store is cleared, the next
+// candidate starts a new list and the oversized-packet budget and counts
+// start over with it.
+//
+// offer() runs on the capture thread; the other members may be called
+// from any thread.
+class StandingFilter {
+public:
+    enum { kBlockSize = 4096 };
+
+private:
+    struct Block {
+        uint32_t indexes[kBlockSize];
+        int ids[kBlockSize];
+    };
+
+    struct Directory {
+        std::atomic<Block*>* slots;
+        size_t capacity;
+        std::atomic<size_t> count;      // indexes visible to readers
+        std::atomic<uint64_t> skipped;  // oversized matches left out
+        uint64_t generation;            // of the PacketStore they point into
+        bool ownsBlocks;
+
+        Directory(size_t cap, uint64_t gen) : slots(new std::atomic<Block*>[cap]), capacity(cap),
+                                              count(0), skipped(0), generation(gen), ownsBlocks(false) {
+            for (size_t i = 0; i < cap; i++) slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~Directory() {
+            if (ownsBlocks) {
+                size_t used = (count.load() + kBlockSize - 1) / kBlockSize;
+                for (size_t i = 0; i < used; i++) delete slots[i].load();
+            }
+            delete[] slots;
+        }
+    };
+
+    std::string srcIP;
+    std::string dstIP;
+    uint64_t srcKey;
+    uint64_t dstKey;
+    bool anySrc;
+    bool anyDst;
+    int oversizedThreshold;
+    int oversizedCount;                 // capture thread only
+
+    std::atomic<Directory*> current;
+    mutable EpochManager epochs;
+
+public:
+    // Matches recorded so far in the current generation, as of the moment
+    // it was taken.
+    class Snapshot {
+    public:
+        explicit Snapshot(const StandingFilter& filter)
+            : guard(filter.epochs), dir(filter.current.load()),
+              count(dir->count.load(std::memory_order_acquire)) {}
+
+        size_t size() const {
+            return count;
+        }
+
+        // Oversized matches the threshold left out of this generation.
+        uint64_t skipped() const {
+            return dir->skipped.load(std::memory_order_relaxed);
+        }
+
+        // PacketStore generation the indexes belong to.
+        uint64_t generation() const {
+            return dir->generation;
+        }
+
+        uint32_t index(size_t i) const {
+            return block(i)->indexes[i % kBlockSize];
+        }
+
+        int id(size_t i) const {
+            return block(i)->ids[i % kBlockSize];
+        }
+
+    private:
+        EpochManager::Guard guard;
+        const Directory* dir;
+        size_t count;
+
+        const Block* block(size_t i) const {
+            return dir->slots[i / kBlockSize].load(std::memory_order_acquire);
+        }
+
+        Snapshot(const Snapshot&);
+        Snapshot& operator=(const Snapshot&);
+    };
+
+    // "*" matches any address. `generation` is the store's current one.
+    StandingFilter(const std::string& src, const std::string& dst, int threshold, uint64_t generation)
+        : srcIP(src), dstIP(dst), srcKey(Packet::addressKey(src)), dstKey(Packet::addressKey(dst)),
+          anySrc(src == "*"), anyDst(dst == "*"), oversizedThreshold(threshold), oversizedCount(0),
+          current(new Directory(16, generation)) {}
+
+    ~StandingFilter() {
+        Directory* d = current.load();
+        d->ownsBlocks = true;
+        delete d;
+    }
+
+    const std::string& source() const {
+        return srcIP;
+    }
+
+    const std::string& destination() const {
+        return dstIP;
+    }
+
+    // Records the packet's store index and ID if it matches; `generation`
+    // is the store generation it was appended to. The 8-byte address keys reject almost
+    // every packet; the strings settle the rest (IPv6 keys are hashes).
+    bool offer(const Packet& p, size_t storeIndex, uint64_t generation) {
+        if ((!anySrc && p.srcKey != srcKey) || (!anyDst && p.dstKey != dstKey)) return false;
+        if ((!anySrc && p.srcIP != srcIP) || (!anyDst && p.dstIP != dstIP)) return false;
+
+        Directory* d = current.load();
+        if (d->generation != generation) d = restart(generation);
+        if (p.size > 1500 && ++oversizedCount > oversizedThreshold) {
+            d->skipped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        append(d, static_cast<uint32_t>(storeIndex), p.id);
+        return true;
+    }
+
+private:
+    // The store was cleared: drop the old matches and start counting again.
+    Directory* restart(uint64_t generation) {
+        Directory* old = current.load();
+        Directory* d = new Directory(16, generation);
+        current.store(d);
+        old->ownsBlocks = true;
+        epochs.retire(old);
+        oversizedCount = 0;
+        return d;
+    }
+
+    void append(Directory* d, uint32_t index, int id) {
+        size_t n = d->count.load(std::memory_order_relaxed);
+        size_t bi = n / kBlockSize;
+        if (n % kBlockSize == 0) {
+            if (bi == d->capacity) d = grow(d);
+            d->slots[bi].store(new Block(), std::memory_order_release);
+        }
+        Block* b = d->slots[bi].load(std::memory_order_relaxed);
+        b->indexes[n % kBlockSize] = index;
+        b->ids[n % kBlockSize] = id;
+        d->count.store(n + 1, std::memory_order_release);
+        if (epochs.hasPending()) epochs.reclaim();
+    }
+
+    // New directory with twice the slots; the blocks are shared.
+    Directory* grow(Directory* old) {
+        Directory* d = new Directory(old->capacity * 2, old->generation);
+        for (size_t i = 0; i < old->capacity; i++) {
+            d->slots[i].store(old->slots[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        d->count.store(old->count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        d->skipped.store(old->skipped.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        current.store(d);
+        epochs.retire(old);
+        return d;
+    }
+
+    StandingFilter(const StandingFilter&);
+    StandingFilter& operator=(const StandingFilter&);
+};
+
+#endif
\ No newline at end of file
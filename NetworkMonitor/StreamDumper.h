@@ -0,0 +1,121 @@
+#ifndef STREAM_DUMPER_H
+#define STREAM_DUMPER_H
+
+#include "TcpReassembler.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+// Saves reassembled TCP streams, one file per direction named
+// <src>.<sport>-<dst>.<dport>.bin, appending bytes as the reassembler
+// delivers them. Files are kept open between writes; once kMaxOpenFiles
+// are open they are all closed and reopened on demand.
+//
+// write() runs on the capture thread; the counters may be read from any
+// thread.
+class StreamDumper {
+public:
+    enum { kMaxOpenFiles = 128 };
+
+private:
+    std::string directory;
+    std::unordered_map<std::string, FILE*> files;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> filesCreated;
+    std::atomic<uint64_t> writeErrors;
+
+public:
+    StreamDumper() : bytesWritten(0), filesCreated(0), writeErrors(0) {}
+
+    ~StreamDumper() {
+        close();
+    }
+
+    bool open(const std::string& dir) {
+        close();
+        if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) return false;
+        if (access(dir.c_str(), W_OK) != 0) return false;
+        directory = dir;
+        bytesWritten = 0;
+        filesCreated = 0;
+        writeErrors = 0;
+        return true;
+    }
+
+    void close() {
+        closeFiles();
+        directory.clear();
+    }
+
+    // Pushes buffered bytes to the files, e.g. when a capture ends.
+    void flush() {
+        for (std::unordered_map<std::string, FILE*>::iterator it = files.begin(); it != files.end(); ++it) {
+            if (fflush(it->second) != 0) writeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool isOpen() const {
+        return !directory.empty();
+    }
+
+    const std::string& getDirectory() const {
+        return directory;
+    }
+
+    uint64_t bytes() const { return bytesWritten.load(std::memory_order_relaxed); }
+    uint64_t fileCount() const { return filesCreated.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return writeErrors.load(std::memory_order_relaxed); }
+
+    void write(const TcpReassembler::StreamInfo& info, const unsigned char* data, size_t len) {
+        if (directory.empty()) return;
+        std::string name = fileName(info);
+        std::unordered_map<std::string, FILE*>::iterator it = files.find(name);
+        FILE* f;
+        if (it != files.end()) {
+            f = it->second;
+        } else {
+            if (files.size() >= kMaxOpenFiles) closeFiles();
+            std::string path = directory + "/" + name;
+            bool existed = access(path.c_str(), F_OK) == 0;
+            f = fopen(path.c_str(), "ab");
+            if (!f) {
+                writeErrors.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            if (!existed) filesCreated.fetch_add(1, std::memory_order_relaxed);
+            files[name] = f;
+        }
+        if (fwrite(data, 1, len, f) != len) {
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        bytesWritten.fetch_add(len, std::memory_order_relaxed);
+    }
+
+private:
+    void closeFiles() {
+        for (std::unordered_map<std::string, FILE*>::iterator it = files.begin(); it != files.end(); ++it) {
+            fclose(it->second);
+        }
+        files.clear();
+    }
+
+    // IPv6 colons become dots so the names work on any file system.
+    static std::string fileName(const TcpReassembler::StreamInfo& info) {
+        std::string name = info.srcIP + "." + std::to_string(info.srcPort) + "-" +
+                           info.dstIP + "." + std::to_string(info.dstPort) + ".bin";
+        for (size_t i = 0; i < name.size(); i++) {
+            if (name[i] == ':') name[i] = '.';
+        }
+        return name;
+    }
+
+    StreamDumper(const StreamDumper&);
+    StreamDumper& operator=(const StreamDumper&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,445 @@
+#ifndef TCP_REASSEMBLER_H
+#define TCP_REASSEMBLER_H
+
+#include "Packet.h"
+#include <netinet/tcp.h>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+
+// Rebuilds in-order TCP byte streams from dissected packets. Each
+// connection tracks the sequence space of both directions; segments that
+// arrive ahead of a gap are parked in a shared pool of fixed-size blocks.
+// Memory is bounded by a per-connection cap (both directions together), a
+// global pool cap and a maximum flow count (least recently used flows are
+// evicted first). Flows are found by a fixed-size binary key built from
+// the packet's address keys and ports, so no lookup allocates.
+class TcpReassembler {
+public:
+    struct StreamInfo {
+        std::string srcIP;
+        std::string dstIP;
+        uint16_t srcPort;
+        uint16_t dstPort;
+    };
+
+    typedef std::function<void(const StreamInfo&, const unsigned char*, size_t)> StreamCallback;
+
+    struct Stats {
+        uint64_t flowsOpened;
+        uint64_t flowsClosed;
+        uint64_t flowsEvicted;
+        uint64_t bytesDelivered;
+        uint64_t duplicateBytes;
+        uint64_t gapBytes;          // bytes skipped when a hole never filled
+        uint64_t bytesDiscarded;    // out-of-order data dropped on close/evict
+
+        Stats() : flowsOpened(0), flowsClosed(0), flowsEvicted(0), bytesDelivered(0),
+                  duplicateBytes(0), gapBytes(0), bytesDiscarded(0) {}
+    };
+
+private:
+    // Fixed-size block allocator shared by all flows. Blocks are chained
+    // through `nextBlock` so a segment of any length is a single index.
+    class BlockPool {
+    public:
+        enum { kBlockSize = 512, kSlabBlocks = 256 };
+
+        explicit BlockPool(size_t capBytes) : freeHead(-1), maxBlocks(capBytes / kBlockSize), used(0) {}
+
+        ~BlockPool() {
+            for (size_t i = 0; i < slabs.size(); i++) delete[] slabs[i];
+        }
+
+        void setCapacity(size_t capBytes) {
+            maxBlocks = capBytes / kBlockSize;
+        }
+
+        bool canHold(size_t bytes) const {
+            return used + blocksFor(bytes) <= maxBlocks;
+        }
+
+        size_t bytesInUse() const {
+            return used * kBlockSize;
+        }
+
+        // Copies `len` bytes into a freshly allocated chain. The caller
+        // must have checked canHold().
+        int store(const unsigned char* src, size_t len) {
+            int head = -1, tail = -1;
+            while (len > 0) {
+                int b = allocate();
+                size_t n = len < kBlockSize ? len : static_cast<size_t>(kBlockSize);
+                memcpy(block(b), src, n);
+                if (tail < 0) head = b; else nextBlock[tail] = b;
+                tail = b;
+                src += n;
+                len -= n;
+            }
+            return head;
+        }
+
+        void release(int head) {
+            while (head >= 0) {
+                int next = nextBlock[head];
+                nextBlock[head] = freeHead;
+                freeHead = head;
+                used--;
+                head = next;
+            }
+        }
+
+        unsigned char* block(int b) {
+            return slabs[b / kSlabBlocks] + static_cast<size_t>(b % kSlabBlocks) * kBlockSize;
+        }
+
+        int next(int b) const {
+            return nextBlock[b];
+        }
+
+    private:
+        std::vector<unsigned char*> slabs;
+        std::vector<int> nextBlock;
+        int freeHead;
+        size_t maxBlocks;
+        size_t used;
+
+        static size_t blocksFor(size_t bytes) {
+            return (bytes + kBlockSize - 1) / kBlockSize;
+        }
+
+        int allocate() {
+            if (freeHead < 0) {
+                int base = static_cast<int>(nextBlock.size());
+                slabs.push_back(new unsigned char[static_cast<size_t>(kSlabBlocks) * kBlockSize]);
+                nextBlock.resize(nextBlock.size() + kSlabBlocks);
+                for (int i = kSlabBlocks - 1; i >= 0; i--) {
+                    nextBlock[base + i] = freeHead;
+                    freeHead = base + i;
+                }
+            }
+            int b = freeHead;
+            freeHead = nextBlock[b];
+            nextBlock[b] = -1;
+            used++;
+            return b;
+        }
+
+        BlockPool(const BlockPool&);
+        BlockPool& operator=(const BlockPool&);
+    };
+
+    struct Segment {
+        uint32_t seq;
+        uint32_t len;
+        int head;
+    };
+
+    // Both endpoints (address key, port), lower endpoint first so the two
+    // directions of a connection share a key.
+    struct FlowKey {
+        uint64_t addrA;
+        uint64_t addrB;
+        uint16_t portA;
+        uint16_t portB;
+
+        bool operator==(const FlowKey& o) const {
+            return addrA == o.addrA && addrB == o.addrB && portA == o.portA && portB == o.portB;
+        }
+    };
+
+    struct FlowKeyHash {
+        size_t operator()(const FlowKey& k) const {
+            uint64_t h = k.addrA * 0x9E3779B97F4A7C15ULL;
+            h ^= k.addrB + 0x632BE59BD9B4E019ULL + (h << 6) + (h >> 2);
+            h ^= ((static_cast<uint64_t>(k.portA) << 16) | k.portB) + (h << 6) + (h >> 2);
+            return static_cast<size_t>(h ^ (h >> 32));
+        }
+    };
+
+    struct Direction {
+        StreamInfo info;
+        uint64_t srcKey;
+        bool initialized;
+        bool finished;
+        uint32_t nextSeq;
+        size_t buffered;
+        std::vector<Segment> pending;     // sorted by distance from nextSeq
+
+        Direction() : srcKey(0), initialized(false), finished(false), nextSeq(0), buffered(0) {}
+    };
+
+    struct Flow {
+        FlowKey key;
+        Direction dir[2];
+        int64_t lastSeen;
+
+        size_t buffered() const {
+            return dir[0].buffered + dir[1].buffered;
+        }
+    };
+
+    typedef std::list<Flow>::iterator FlowIter;
+
+    std::list<Flow> flows;                              // least recently used first
+    std::unordered_map<FlowKey, FlowIter, FlowKeyHash> index;
+    BlockPool pool;
+    StreamCallback callback;
+    Stats stats;
+
+    size_t perFlowCap;                                  // both directions together
+    size_t maxFlows;
+    int64_t idleTimeoutUsec;
+
+public:
+    TcpReassembler(size_t perFlowBytes = 256 * 1024, size_t globalBytes = 64 * 1024 * 1024,
+                   size_t flowLimit = 65536, int idleSeconds = 120)
+        : pool(globalBytes), perFlowCap(perFlowBytes), maxFlows(flowLimit),
+          idleTimeoutUsec(static_cast<int64_t>(idleSeconds) * 1000000) {}
+
+    void setCallback(const StreamCallback& cb) {
+        callback = cb;
+    }
+
+    void setLimits(size_t perFlowBytes, size_t globalBytes, size_t flowLimit, int idleSeconds) {
+        perFlowCap = perFlowBytes;
+        pool.setCapacity(globalBytes);
+        maxFlows = flowLimit;
+        idleTimeoutUsec = static_cast<int64_t>(idleSeconds) * 1000000;
+    }
+
+    const Stats& getStats() const {
+        return stats;
+    }
+
+    size_t activeFlows() const {
+        return flows.size();
+    }
+
+    size_t bytesBuffered() const {
+        return pool.bytesInUse();
+    }
+
+    void process(const Packet& p) {
+        if (p.protocol != "TCP" || p.payloadOffset == 0) return;
+
+        int64_t now = static_cast<int64_t>(p.timestamp.tv_sec) * 1000000 + p.timestamp.tv_usec;
+        FlowIter it = lookup(p, now);
+        Flow& f = *it;
+        Direction& d = f.dir[p.srcKey == f.dir[0].srcKey && p.srcPort == f.dir[0].info.srcPort ? 0 : 1];
+
+        uint32_t seq = p.tcpSeq;
+        if (p.tcpFlags & TH_SYN) {
+            seq++;
+            if (!d.initialized) {
+                d.initialized = true;
+                d.nextSeq = seq;
+            }
+        } else if (!d.initialized) {
+            // Picked up mid-connection: start the stream at the first byte seen.
+            d.initialized = true;
+            d.nextSeq = seq;
+        }
+
+        if (p.payloadLength > 0) {
+            handleData(f, d, seq, p.data.data() + p.payloadOffset, static_cast<uint32_t>(p.payloadLength));
+        }
+
+        if (p.tcpFlags & TH_RST) {
+            removeFlow(it);
+            stats.flowsClosed++;
+        } else if (p.tcpFlags & TH_FIN) {
+            d.finished = true;
+            if (f.dir[0].finished && f.dir[1].finished) {
+                removeFlow(it);
+                stats.flowsClosed++;
+            }
+        }
+    }
+
+    // Evicts flows that have been idle longer than the timeout. Meant to
+    // be called periodically from the capture loop.
+    void expire(int64_t nowUsec) {
+        while (!flows.empty() && flows.front().lastSeen + idleTimeoutUsec < nowUsec) {
+            removeFlow(flows.begin());
+            stats.flowsEvicted++;
+        }
+    }
+
+    void clear() {
+        while (!flows.empty()) removeFlow(flows.begin());
+    }
+
+private:
+    FlowIter lookup(const Packet& p, int64_t now) {
+        FlowKey key;
+        bool srcFirst = p.srcKey < p.dstKey || (p.srcKey == p.dstKey && p.srcPort <= p.dstPort);
+        key.addrA = srcFirst ? p.srcKey : p.dstKey;
+        key.addrB = srcFirst ? p.dstKey : p.srcKey;
+        key.portA = srcFirst ? p.srcPort : p.dstPort;
+        key.portB = srcFirst ? p.dstPort : p.srcPort;
+
+        std::unordered_map<FlowKey, FlowIter, FlowKeyHash>::iterator found = index.find(key);
+        if (found != index.end()) {
+            FlowIter it = found->second;
+            const StreamInfo& fwd = it->dir[0].info;
+            // IPv4 keys are exact; hashed IPv6 keys are confirmed.
+            bool hashed = ((key.addrA | key.addrB) >> 63) != 0;
+            bool same = !hashed || (p.srcIP == fwd.srcIP && p.dstIP == fwd.dstIP) ||
+                        (p.srcIP == fwd.dstIP && p.dstIP == fwd.srcIP);
+            if (same) {
+                flows.splice(flows.end(), flows, it);
+                it->lastSeen = now;
+                return it;
+            }
+            // Two IPv6 connections whose hashed address keys collide: the
+            // older one gives way.
+            removeFlow(it);
+            stats.flowsEvicted++;
+        }
+
+        if (flows.size() >= maxFlows && !flows.empty()) {
+            removeFlow(flows.begin());
+            stats.flowsEvicted++;
+        }
+
+        flows.push_back(Flow());
+        FlowIter it = --flows.end();
+        it->key = key;
+        it->lastSeen = now;
+        it->dir[0].srcKey = p.srcKey;
+        it->dir[1].srcKey = p.dstKey;
+        StreamInfo& fwd = it->dir[0].info;
+        fwd.srcIP = p.srcIP;
+        fwd.dstIP = p.dstIP;
+        fwd.srcPort = p.srcPort;
+        fwd.dstPort = p.dstPort;
+        StreamInfo& rev = it->dir[1].info;
+        rev.srcIP = p.dstIP;
+        rev.dstIP = p.srcIP;
+        rev.srcPort = p.dstPort;
+        rev.dstPort = p.srcPort;
+        index[key] = it;
+        stats.flowsOpened++;
+        return it;
+    }
+
+    void removeFlow(FlowIter it) {
+        for (int i = 0; i < 2; i++) {
+            Direction& d = it->dir[i];
+            for (size_t s = 0; s < d.pending.size(); s++) {
+                stats.bytesDiscarded += d.pending[s].len;
+                pool.release(d.pending[s].head);
+            }
+        }
+        index.erase(it->key);
+        flows.erase(it);
+    }
+
+    static int32_t seqDiff(uint32_t a, uint32_t b) {
+        return static_cast<int32_t>(a - b);
+    }
+
+    void deliver(Direction& d, const unsigned char* data, size_t len) {
+        stats.bytesDelivered += len;
+        if (callback) callback(d.info, data, len);
+    }
+
+    void handleData(Flow& f, Direction& d, uint32_t seq, const unsigned char* data, uint32_t len) {
+        int32_t diff = seqDiff(seq, d.nextSeq);
+        if (diff <= 0) {
+            uint32_t skip = static_cast<uint32_t>(-static_cast<int64_t>(diff));
+            if (skip >= len) {
+                stats.duplicateBytes += len;
+                return;
+            }
+            stats.duplicateBytes += skip;
+            deliver(d, data + skip, len - skip);
+            d.nextSeq += len - skip;
+            drain(d);
+            return;
+        }
+
+        if (f.buffered() + len > perFlowCap || !pool.canHold(len)) {
+            // Out of budget: stop waiting for the hole and move on.
+            skipGap(d);
+            if (seqDiff(seq, d.nextSeq) <= 0 || f.buffered() + len > perFlowCap || !pool.canHold(len)) {
+                if (seqDiff(seq, d.nextSeq) > 0) {
+                    stats.gapBytes += static_cast<uint32_t>(seqDiff(seq, d.nextSeq));
+                    d.nextSeq = seq;
+                }
+                handleData(f, d, seq, data, len);
+                return;
+            }
+        }
+
+        size_t pos = 0;
+        while (pos < d.pending.size() && seqDiff(d.pending[pos].seq, seq) < 0) pos++;
+        if (pos < d.pending.size() && d.pending[pos].seq == seq && d.pending[pos].len >= len) {
+            stats.duplicateBytes += len;
+            return;
+        }
+
+        Segment s;
+        s.seq = seq;
+        s.len = len;
+        s.head = pool.store(data, len);
+        d.pending.insert(d.pending.begin() + pos, s);
+        d.buffered += len;
+    }
+
+    // Jumps over the hole in front of the oldest parked segment.
+    void skipGap(Direction& d) {
+        if (d.pending.empty()) return;
+        int32_t gap = seqDiff(d.pending.front().seq, d.nextSeq);
+        if (gap > 0) {
+            stats.gapBytes += static_cast<uint32_t>(gap);
+            d.nextSeq = d.pending.front().seq;
+        }
+        drain(d);
+    }
+
+    void drain(Direction& d) {
+        while (!d.pending.empty()) {
+            Segment s = d.pending.front();
+            int32_t diff = seqDiff(s.seq, d.nextSeq);
+            if (diff > 0) break;
+
+            uint32_t skip = static_cast<uint32_t>(-static_cast<int64_t>(diff));
+            if (skip < s.len) {
+                stats.duplicateBytes += skip;
+                deliverChain(d, s.head, skip, s.len - skip);
+                d.nextSeq += s.len - skip;
+            } else {
+                stats.duplicateBytes += s.len;
+            }
+            d.buffered -= s.len;
+            pool.release(s.head);
+            d.pending.erase(d.pending.begin());
+        }
+    }
+
+    void deliverChain(Direction& d, int head, uint32_t skip, uint32_t len) {
+        for (int b = head; b >= 0 && len > 0; b = pool.next(b)) {
+            uint32_t blockLen = BlockPool::kBlockSize;
+            if (skip >= blockLen) {
+                skip -= blockLen;
+                continue;
+            }
+            uint32_t n = blockLen - skip;
+            if (n > len) n = len;
+            deliver(d, pool.block(b) + skip, n);
+            len -= n;
+            skip = 0;
+        }
+    }
+
+    TcpReassembler(const TcpReassembler&);
+    TcpReassembler& operator=(const TcpReassembler&);
+};
+
+#endif
\ No newline at end of file
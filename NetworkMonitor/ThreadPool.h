@@ -0,0 +1,124 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <pthread.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. parallelFor()
+// hands out task indexes from a shared counter to the workers and the
+// calling thread alike, and returns once every task has run.
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex lock;
+    std::condition_variable wake;
+    std::condition_variable done;
+
+    const std::function<void(size_t)>* job;
+    size_t jobCount;
+    uint64_t generation;
+    size_t active;                      // workers still inside the job
+    bool stopping;
+    std::atomic<size_t> next;
+    std::atomic<size_t> pending;
+
+public:
+    // threads == 0: one per hardware thread, the caller included.
+    explicit ThreadPool(size_t threads = 0)
+        : job(nullptr), jobCount(0), generation(0), active(0), stopping(false), next(0), pending(0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 1; i < threads; i++) workers.push_back(std::thread(&ThreadPool::workerLoop, this));
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+    }
+
+    size_t size() const {
+        return workers.size() + 1;
+    }
+
+    // Restricts the worker threads (not the caller) to a set of CPUs.
+    bool setAffinity(const cpu_set_t& set) {
+        bool ok = true;
+        for (size_t i = 0; i < workers.size(); i++) {
+            ok = pthread_setaffinity_np(workers[i].native_handle(), sizeof(set), &set) == 0 && ok;
+        }
+        return ok;
+    }
+
+    // Runs fn(0) .. fn(count - 1), in any order and on any thread. Not
+    // reentrant: one parallelFor at a time.
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (workers.empty() || count <= 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            job = &fn;
+            jobCount = count;
+            next = 0;
+            pending = count;
+            active = workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        runTasks(fn, count);
+
+        std::unique_lock<std::mutex> guard(lock);
+        done.wait(guard, [this]() { return pending == 0 && active == 0; });
+        job = nullptr;
+    }
+
+private:
+    void workerLoop() {
+        uint64_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)>* fn;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                wake.wait(guard, [&]() { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+                count = jobCount;
+            }
+            runTasks(*fn, count);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (--active == 0) done.notify_all();
+            }
+        }
+    }
+
+    void runTasks(const std::function<void(size_t)>& fn, size_t count) {
+        for (;;) {
+            size_t i = next.fetch_add(1);
+            if (i >= count) return;
+            fn(i);
+            if (pending.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> guard(lock);
+                done.notify_all();
+            }
+        }
+    }
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,263 @@
+#ifndef TRAFFIC_GENERATOR_H
+#define TRAFFIC_GENERATOR_H
+
+#include <net/ethernet.h>
+#include <netinet/in.h>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Synthetic packet source for load testing without a raw socket. All
+// frames are built up front from the configured mix (one contiguous
+// buffer of complete Ethernet/IP/L4 frames with valid lengths and IPv4
+// header checksums); producing a packet is then just handing out the
+// next template, so the generator itself costs almost nothing per packet.
+//
+// Each frame handed out is stamped with a few per-emission fields so no
+// two are byte-for-byte equal (duplicate suppression would drop them):
+// the IPv4 ID or IPv6 flow label takes an emission counter, and a TCP
+// segment's sequence number advances by its flow's bytes per cycle, so
+// reassembly sees each flow as one continuous stream.
+class TrafficGenerator {
+public:
+    struct Config {
+        int tcpPercent;         // remainder after TCP and UDP is ICMP
+        int udpPercent;
+        int ipv6Percent;
+        int flows;
+        int minSize;            // whole frame, bytes
+        int maxSize;
+        bool imix;              // 7:4:1 small/576/large instead of uniform
+        int pps;                // rate used by a synthetic capture
+        unsigned seed;
+
+        Config() : tcpPercent(70), udpPercent(25), ipv6Percent(20), flows(256),
+                   minSize(64), maxSize(1500), imix(true), pps(10000), seed(1) {}
+    };
+
+    enum { kTemplates = 4096 };
+
+private:
+    struct Flow {
+        bool ipv6;
+        int proto;
+        unsigned char src[16];
+        unsigned char dst[16];
+        uint16_t srcPort;
+        uint16_t dstPort;
+        uint32_t seq;
+    };
+
+    // Where to stamp a template, and its TCP sequence number per cycle.
+    struct Stamp {
+        bool ipv6;
+        bool tcp;
+        uint32_t seq;
+        uint32_t seqPerCycle;           // payload bytes of the flow per cycle
+        uint32_t cycles;                // times handed out so far
+    };
+
+    Config config;
+    std::vector<unsigned char> frames;
+    std::vector<uint32_t> offsets;      // kTemplates + 1 entries
+    std::vector<Stamp> stamps;
+    size_t cursor;
+    uint32_t emitted;
+    uint32_t rng;
+
+public:
+    explicit TrafficGenerator(const Config& cfg = Config()) : config(cfg), cursor(0), emitted(0), rng(cfg.seed | 1) {
+        config.flows = std::max(config.flows, 1);
+        config.minSize = std::max(config.minSize, 64);
+        config.maxSize = std::min(std::max(config.maxSize, config.minSize), 9000);
+        build();
+    }
+
+    const Config& getConfig() const {
+        return config;
+    }
+
+    size_t templateCount() const {
+        return offsets.size() - 1;
+    }
+
+    // Template `index`, stamped for this emission. The frame stays valid
+    // until the template is handed out again.
+    const unsigned char* frame(size_t index, size_t& len) {
+        len = offsets[index + 1] - offsets[index];
+        unsigned char* p = frames.data() + offsets[index];
+        Stamp& st = stamps[index];
+        unsigned char* ip = p + sizeof(struct ether_header);
+        uint32_t n = emitted++;
+        if (st.ipv6) {
+            ip[1] = static_cast<unsigned char>((ip[1] & 0xf0) | ((n >> 16) & 0x0f));
+            put16(ip + 2, static_cast<uint16_t>(n));
+        } else {
+            put16(ip + 4, static_cast<uint16_t>(n));
+            put16(ip + 10, 0);
+            put16(ip + 10, checksum(ip, 20));
+        }
+        if (st.tcp) {
+            put32(ip + (st.ipv6 ? 40 : 20) + 4, st.seq + st.cycles * st.seqPerCycle);
+        }
+        st.cycles++;
+        return p;
+    }
+
+    // Next frame in the cycle of pre-built templates.
+    const unsigned char* next(size_t& len) {
+        const unsigned char* f = frame(cursor, len);
+        if (++cursor == templateCount()) cursor = 0;
+        return f;
+    }
+
+private:
+    uint32_t random() {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return rng;
+    }
+
+    size_t pickSize() {
+        int lo = config.minSize, hi = config.maxSize;
+        if (!config.imix) return lo + random() % (hi - lo + 1);
+        uint32_t r = random() % 12;
+        if (r < 7) return lo;
+        if (r < 11) return std::min(std::max(576, lo), hi);
+        return hi;
+    }
+
+    void build() {
+        std::vector<Flow> flows(config.flows);
+        for (size_t i = 0; i < flows.size(); i++) {
+            Flow& f = flows[i];
+            uint32_t r = random() % 100;
+            f.proto = static_cast<int>(r) < config.tcpPercent ? IPPROTO_TCP
+                    : static_cast<int>(r) < config.tcpPercent + config.udpPercent ? IPPROTO_UDP
+                    : IPPROTO_ICMP;
+            f.ipv6 = static_cast<int>(random() % 100) < config.ipv6Percent;
+            if (f.ipv6 && f.proto == IPPROTO_ICMP) f.proto = IPPROTO_ICMPV6;
+
+            memset(f.src, 0, sizeof(f.src));
+            memset(f.dst, 0, sizeof(f.dst));
+            if (f.ipv6) {
+                f.src[0] = f.dst[0] = 0xfd;
+                f.src[15] = static_cast<unsigned char>(1 + i % 250);
+                f.src[14] = static_cast<unsigned char>(i / 250);
+                f.dst[15] = static_cast<unsigned char>(1 + random() % 8);
+                f.dst[1] = 1;
+            } else {
+                f.src[0] = 10; f.src[2] = static_cast<unsigned char>(i / 250);
+                f.src[3] = static_cast<unsigned char>(1 + i % 250);
+                f.dst[0] = 192; f.dst[1] = 168; f.dst[2] = 1;
+                f.dst[3] = static_cast<unsigned char>(1 + random() % 8);
+            }
+            f.srcPort = static_cast<uint16_t>(32768 + random() % 28000);
+            static const uint16_t services[] = { 80, 443, 53, 22, 8080, 123 };
+            f.dstPort = services[random() % 6];
+            f.seq = random();
+        }
+
+        std::vector<uint32_t> firstSeq(flows.size());
+        for (size_t i = 0; i < flows.size(); i++) firstSeq[i] = flows[i].seq;
+
+        offsets.push_back(0);
+        for (size_t t = 0; t < kTemplates; t++) {
+            Flow& f = flows[t % flows.size()];
+            Stamp st = { f.ipv6, f.proto == IPPROTO_TCP, f.seq, 0, 0 };
+            stamps.push_back(st);
+            appendFrame(f, pickSize());
+            offsets.push_back(static_cast<uint32_t>(frames.size()));
+        }
+        for (size_t t = 0; t < kTemplates; t++) {
+            size_t fi = t % flows.size();
+            stamps[t].seqPerCycle = flows[fi].seq - firstSeq[fi];
+        }
+        frames.shrink_to_fit();
+    }
+
+    void appendFrame(Flow& f, size_t size) {
+        size_t ipLen = f.ipv6 ? 40 : 20;
+        size_t l4Len = f.proto == IPPROTO_TCP ? 20 : 8;
+        size_t minSize = sizeof(struct ether_header) + ipLen + l4Len;
+        if (size < minSize) size = minSize;
+
+        size_t base = frames.size();
+        frames.resize(base + size);
+        unsigned char* p = frames.data() + base;
+
+        static const unsigned char srcMac[6] = { 0x02, 0, 0, 0, 0, 0x01 };
+        static const unsigned char dstMac[6] = { 0x02, 0, 0, 0, 0, 0x02 };
+        memcpy(p, dstMac, 6);
+        memcpy(p + 6, srcMac, 6);
+        put16(p + 12, f.ipv6 ? ETHERTYPE_IPV6 : ETHERTYPE_IP);
+
+        unsigned char* ip = p + sizeof(struct ether_header);
+        size_t ipTotal = size - sizeof(struct ether_header);
+        if (f.ipv6) {
+            ip[0] = 0x60;
+            put16(ip + 4, static_cast<uint16_t>(ipTotal - 40));
+            ip[6] = static_cast<unsigned char>(f.proto);
+            ip[7] = 64;
+            memcpy(ip + 8, f.src, 16);
+            memcpy(ip + 24, f.dst, 16);
+        } else {
+            ip[0] = 0x45;
+            put16(ip + 2, static_cast<uint16_t>(ipTotal));
+            put16(ip + 4, static_cast<uint16_t>(random()));
+            ip[8] = 64;
+            ip[9] = static_cast<unsigned char>(f.proto);
+            memcpy(ip + 12, f.src, 4);
+            memcpy(ip + 16, f.dst, 4);
+            put16(ip + 10, checksum(ip, 20));
+        }
+
+        unsigned char* l4 = ip + ipLen;
+        size_t payload = size - minSize;
+        if (f.proto == IPPROTO_TCP) {
+            put16(l4, f.srcPort);
+            put16(l4 + 2, f.dstPort);
+            put32(l4 + 4, f.seq);
+            l4[12] = 5 << 4;
+            l4[13] = payload ? 0x18 : 0x10;         // PSH|ACK or ACK
+            put16(l4 + 14, 65535);
+            f.seq += static_cast<uint32_t>(payload);
+        } else if (f.proto == IPPROTO_UDP) {
+            put16(l4, f.srcPort);
+            put16(l4 + 2, f.dstPort);
+            put16(l4 + 4, static_cast<uint16_t>(8 + payload));
+        } else {
+            l4[0] = f.ipv6 ? 128 : 8;               // echo request
+            put16(l4 + 4, f.srcPort);
+            put16(l4 + 6, static_cast<uint16_t>(f.seq++));
+        }
+
+        // Text-like payload so compression and signature scanning see
+        // something closer to real traffic than random bytes.
+        static const char text[] = "GET /index.html HTTP/1.1\r\nHost: example.test\r\n"
+                                   "User-Agent: nm-synthetic/1.0\r\nAccept: */*\r\n\r\n";
+        unsigned char* body = l4 + l4Len;
+        for (size_t i = 0; i < payload; i++) body[i] = static_cast<unsigned char>(text[i % (sizeof(text) - 1)]);
+    }
+
+    static void put16(unsigned char* p, uint16_t v) {
+        p[0] = static_cast<unsigned char>(v >> 8);
+        p[1] = static_cast<unsigned char>(v);
+    }
+
+    static void put32(unsigned char* p, uint32_t v) {
+        put16(p, static_cast<uint16_t>(v >> 16));
+        put16(p + 2, static_cast<uint16_t>(v));
+    }
+
+    static uint16_t checksum(const unsigned char* p, size_t len) {
+        uint32_t sum = 0;
+        for (size_t i = 0; i + 1 < len; i += 2) sum += (p[i] << 8) | p[i + 1];
+        while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+        return static_cast<uint16_t>(~sum);
+    }
+};
+
+#endif
\ No newline at end of file
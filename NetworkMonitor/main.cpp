@@ -16,6 +16,25 @@ void displayMenu() {
     std::cout << "║  8. Display Statistics                     ║\n";
     std::cout << "║  9. Clear Processed Packets                ║\n";
     std::cout << "║  10. RUN COMPLETE DEMO (ALL REQUIREMENTS)  ║\n";
+    std::cout << "║  11. Enable Persistent Store               ║\n";
+    std::cout << "║  12. Display Stored Packets (Time Range)   ║\n";
+    std::cout << "║  13. Filter Stored Packets by IP           ║\n";
+    std::cout << "║  14. Display Packets by Time Range         ║\n";
+    std::cout << "║  15. Display Packets by ID Range           ║\n";
+    std::cout << "║  16. Toggle TCP Stream Reassembly          ║\n";
+    std::cout << "║  17. Stop Background Capture               ║\n";
+    std::cout << "║  18. Toggle Duplicate Frame Suppression    ║\n";
+    std::cout << "║  19. Toggle In-Memory Payload Compression  ║\n";
+    std::cout << "║  20. Synthetic Load Test                   ║\n";
+    std::cout << "║  21. Overload Control (Sampling Mode)      ║\n";
+    std::cout << "║  22. Load Payload Signatures               ║\n";
+    std::cout << "║  23. Filter Packets by Signature Match     ║\n";
+    std::cout << "║  24. Capture Tuning (CPU/Busy Poll/NUMA)   ║\n";
+    std::cout << "║  25. Display Drops by Capture Mode         ║\n";
+    std::cout << "║  26. Add Standing IP Filter                ║\n";
+    std::cout << "║  27. Display Standing Filters              ║\n";
+    std::cout << "║  28. Use Standing Filter as Replay List    ║\n";
+    std::cout << "║  29. Remove Standing Filter                ║\n";
     std::cout << "║  0. Exit                                   ║\n";
     std::cout << "╚════════════════════════════════════════════╝\n";
 }
@@ -130,10 +149,11 @@ int main() {
     std::cout << "║     CS250 Assignment 2 - All Requirements Met          ║\n";
     std::cout << "╚════════════════════════════════════════════════════════╝\n";
     std::cout << "\n⚠️  This application requires ROOT privileges!\n";
-    std::cout << "Run with: sudo ./network_monitor\n\n";
+    std::cout << "Run with: sudo ./network_monitor\n";
+    std::cout << "(Enter \"synthetic\" as the interface to run on generated traffic without root.)\n\n";
     
     std::string iface;
-    std::cout << "Enter network interface name (e.g., eth0, wlan0, ens33): ";
+    std::cout << "Enter network interface name(s) (e.g., eth0, or eth0,eth1 for several): ";
     std::cin >> iface;
     std::cin.ignore();
     
@@ -157,14 +177,34 @@ int main() {
                     std::cin >> duration;
                     std::cin.ignore();
                     if (duration <= 0) duration = 60;
-                    monitor.capturePacketsContinuous(duration);
+                    if (monitor.isSynthetic()) {
+                        int pps;
+                        std::cout << "Enter synthetic traffic rate in packets/sec (e.g. 10000): ";
+                        std::cin >> pps;
+                        std::cin.ignore();
+                        monitor.setSyntheticRate(pps);
+                    }
+                    char background;
+                    std::cout << "Run in background while using the menu? (y/n): ";
+                    std::cin >> background;
+                    std::cin.ignore();
+                    if (background == 'y' || background == 'Y') {
+                        monitor.startCapture(duration);
+                    } else {
+                        monitor.capturePacketsContinuous(duration);
+                    }
                     break;
                 }
                 
-                case 2:
+                case 2: {
                     // REQUIREMENT: "Show current packet list (IDs, timestamps, IPs)"
-                    monitor.displayPackets();
+                    int page;
+                    std::cout << "Enter page number (1 = first page): ";
+                    std::cin >> page;
+                    std::cin.ignore();
+                    monitor.displayPackets(page);
                     break;
+                }
                 
                 case 3: {
                     // REQUIREMENT: "Show dissected layers for a selected packet"
@@ -218,6 +258,244 @@ int main() {
                     runCompleteDemo(monitor);
                     break;
                 
+                case 11: {
+                    std::string dir;
+                    size_t segmentMB;
+                    std::cout << "Enter store directory: ";
+                    std::cin >> dir;
+                    size_t memoryPackets;
+                    std::cout << "Enter segment size in MB (e.g. 64): ";
+                    std::cin >> segmentMB;
+                    std::cout << "Packets to keep in memory (e.g. 100000, 0 = keep all): ";
+                    std::cin >> memoryPackets;
+                    std::cin.ignore();
+                    if (segmentMB == 0) segmentMB = 64;
+                    monitor.enablePersistentStore(dir, segmentMB, memoryPackets);
+                    break;
+                }
+                
+                case 12: {
+                    double fromSec, toSec;
+                    std::cout << "Enter start time (epoch seconds): ";
+                    std::cin >> fromSec;
+                    std::cout << "Enter end time (epoch seconds): ";
+                    std::cin >> toSec;
+                    std::cin.ignore();
+                    monitor.displayStoredPackets(fromSec, toSec);
+                    break;
+                }
+                
+                case 13: {
+                    std::string src, dst;
+                    std::cout << "Enter Source IP: ";
+                    std::cin >> src;
+                    std::cout << "Enter Destination IP: ";
+                    std::cin >> dst;
+                    std::cin.ignore();
+                    monitor.filterStoredPackets(src, dst);
+                    break;
+                }
+                
+                case 14: {
+                    double fromSec, toSec;
+                    std::cout << "Enter start time (epoch seconds): ";
+                    std::cin >> fromSec;
+                    std::cout << "Enter end time (epoch seconds): ";
+                    std::cin >> toSec;
+                    std::cin.ignore();
+                    monitor.displayPacketsByTime(fromSec, toSec);
+                    break;
+                }
+                
+                case 15: {
+                    int fromId, toId;
+                    std::cout << "Enter first packet ID: ";
+                    std::cin >> fromId;
+                    std::cout << "Enter last packet ID: ";
+                    std::cin >> toId;
+                    std::cin.ignore();
+                    monitor.displayPacketsById(fromId, toId);
+                    break;
+                }
+                
+                case 16: {
+                    if (monitor.isTcpReassemblyEnabled()) {
+                        monitor.setTcpReassembly(false);
+                        break;
+                    }
+                    monitor.setTcpReassembly(true);
+                    if (!monitor.isTcpReassemblyEnabled()) break;
+                    
+                    char custom;
+                    std::cout << "Customize reassembly limits? (y/n): ";
+                    std::cin >> custom;
+                    if (custom == 'y' || custom == 'Y') {
+                        size_t perFlowKB, totalMB, maxFlows;
+                        int idleSeconds;
+                        std::cout << "Max buffered KB per connection, both directions (e.g. 256): ";
+                        std::cin >> perFlowKB;
+                        std::cout << "Max buffered MB in total (e.g. 64): ";
+                        std::cin >> totalMB;
+                        std::cout << "Max tracked flows (e.g. 65536): ";
+                        std::cin >> maxFlows;
+                        std::cout << "Idle timeout in seconds (e.g. 120): ";
+                        std::cin >> idleSeconds;
+                        monitor.setReassemblyLimits(perFlowKB, totalMB, maxFlows, idleSeconds);
+                    }
+                    std::string dir;
+                    std::cout << "Directory to save reassembled streams to (- = don't save): ";
+                    std::cin >> dir;
+                    std::cin.ignore();
+                    monitor.setStreamDump(dir);
+                    break;
+                }
+                
+                case 17:
+                    monitor.stopCapture();
+                    break;
+                
+                case 18: {
+                    if (monitor.isDeduplicationEnabled()) {
+                        monitor.setDeduplication(false);
+                        break;
+                    }
+                    int windowMs;
+                    std::cout << "Enter duplicate window in ms (e.g. 20): ";
+                    std::cin >> windowMs;
+                    std::cin.ignore();
+                    if (windowMs <= 0) windowMs = 20;
+                    monitor.setDeduplication(true, windowMs);
+                    break;
+                }
+                
+                case 19:
+                    monitor.setCompression(!monitor.isCompressionEnabled());
+                    break;
+                
+                case 20: {
+                    int startPps, maxPps, stepSeconds;
+                    std::cout << "Enter starting rate in packets/sec (e.g. 10000): ";
+                    std::cin >> startPps;
+                    std::cout << "Enter maximum rate in packets/sec (e.g. 640000): ";
+                    std::cin >> maxPps;
+                    std::cout << "Enter seconds per step (e.g. 3): ";
+                    std::cin >> stepSeconds;
+                    
+                    TrafficGenerator::Config traffic;
+                    char custom;
+                    std::cout << "Customize traffic mix? (y/n): ";
+                    std::cin >> custom;
+                    if (custom == 'y' || custom == 'Y') {
+                        char imix;
+                        std::cout << "TCP percent: ";
+                        std::cin >> traffic.tcpPercent;
+                        std::cout << "UDP percent (rest is ICMP): ";
+                        std::cin >> traffic.udpPercent;
+                        std::cout << "IPv6 percent: ";
+                        std::cin >> traffic.ipv6Percent;
+                        std::cout << "Number of flows: ";
+                        std::cin >> traffic.flows;
+                        std::cout << "Minimum frame size: ";
+                        std::cin >> traffic.minSize;
+                        std::cout << "Maximum frame size: ";
+                        std::cin >> traffic.maxSize;
+                        std::cout << "IMIX size mix (y) or uniform (n)? ";
+                        std::cin >> imix;
+                        traffic.imix = (imix == 'y' || imix == 'Y');
+                    }
+                    std::cin.ignore();
+                    traffic.pps = startPps;
+                    monitor.runLoadTest(traffic, startPps, maxPps, stepSeconds);
+                    break;
+                }
+                
+                case 21: {
+                    int mode;
+                    std::cout << "Overload control: 0 = off, 1 = 1-in-N packet sampling, 2 = flow-hash sampling: ";
+                    std::cin >> mode;
+                    std::cin.ignore();
+                    if (mode == 1) {
+                        monitor.setOverloadControl(OverloadController::PacketSampling);
+                    } else if (mode == 2) {
+                        monitor.setOverloadControl(OverloadController::FlowSampling);
+                    } else {
+                        monitor.setOverloadControl(OverloadController::Off);
+                    }
+                    break;
+                }
+                
+                case 22: {
+                    std::string path;
+                    std::cout << "Enter signature file path (or 'off' to disable): ";
+                    std::cin >> path;
+                    std::cin.ignore();
+                    monitor.loadSignatures(path);
+                    break;
+                }
+                
+                case 23: {
+                    int signatureId;
+                    std::cout << "Enter signature number (-1 = any signature): ";
+                    std::cin >> signatureId;
+                    std::cin.ignore();
+                    monitor.filterSignatureMatches(signatureId);
+                    break;
+                }
+                
+                case 24: {
+                    int captureCpu, workerCpu;
+                    char busy, numa;
+                    std::cout << "CPU for the capture thread (-1 = unpinned): ";
+                    std::cin >> captureCpu;
+                    std::cout << "CPU for the compression worker (-1 = unpinned): ";
+                    std::cin >> workerCpu;
+                    std::cout << "Busy-poll instead of sleeping? (y/n): ";
+                    std::cin >> busy;
+                    std::cout << "Allocate receive buffers on the NIC's NUMA node? (y/n): ";
+                    std::cin >> numa;
+                    std::cin.ignore();
+                    monitor.setCaptureTuning(captureCpu, workerCpu, busy == 'y' || busy == 'Y',
+                                             numa == 'y' || numa == 'Y');
+                    break;
+                }
+                
+                case 25:
+                    monitor.displayCaptureModeReport();
+                    break;
+                
+                case 26: {
+                    std::string src, dst;
+                    std::cout << "Enter Source IP (* = any): ";
+                    std::cin >> src;
+                    std::cout << "Enter Destination IP (* = any): ";
+                    std::cin >> dst;
+                    std::cin.ignore();
+                    monitor.addStandingFilter(src, dst);
+                    break;
+                }
+                
+                case 27:
+                    monitor.displayStandingFilters();
+                    break;
+                
+                case 28: {
+                    int number;
+                    std::cout << "Enter standing filter number: ";
+                    std::cin >> number;
+                    std::cin.ignore();
+                    monitor.useStandingFilter(number);
+                    break;
+                }
+                
+                case 29: {
+                    int number;
+                    std::cout << "Enter standing filter number to remove: ";
+                    std::cin >> number;
+                    std::cin.ignore();
+                    monitor.removeStandingFilter(number);
+                    break;
+                }
+                
                 case 0:
                     running = false;
                     std::cout << "\n✅ Shutting down Network Monitor...\n";